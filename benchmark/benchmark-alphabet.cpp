@@ -0,0 +1,208 @@
+/*
+Copyright 2026 Rogier van Dalen.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+/** \file
+Measure the speed of looking up symbols in an alphabet, with the hashed and the
+ordered symbol mappings.
+*/
+
+#include "math/alphabet.hpp"
+#include "math/mapped_alphabet.hpp"
+
+#include <cstdio>
+#include <memory>
+#include <vector>
+#include <string>
+
+#include <boost/utility/string_ref.hpp>
+
+#include "benchmark.hpp"
+
+template <class Symbol, class SymbolMapping>
+    void benchmark_alphabet (std::string const & name,
+        std::vector <Symbol> const & symbols)
+{
+    typedef math::alphabet <Symbol, void, 0xFFFFFF7F, meta::vector<>, 0x80,
+        SymbolMapping> alphabet_type;
+    typedef typename alphabet_type::dense_symbol_type dense_symbol_type;
+    std::size_t const repetitions = 20;
+
+    alphabet_type alphabet;
+    benchmark::measure (name + " add_symbol", symbols.size(), 1, [&]() {
+            alphabet_type fresh;
+            for (Symbol const & symbol : symbols)
+                benchmark::keep (fresh.add_symbol (symbol));
+        });
+    benchmark::measure (name + " add_symbols", symbols.size(), 1, [&]() {
+            alphabet_type fresh;
+            fresh.add_symbols (symbols);
+            benchmark::keep (fresh.normal_symbol_num());
+        });
+    for (Symbol const & symbol : symbols)
+        alphabet.add_symbol (symbol);
+
+    // Look up in a different order from the order of insertion.
+    std::vector <Symbol> queries;
+    for (std::size_t i = 0; i != symbols.size(); ++ i)
+        queries.push_back (symbols [(i * 7919) % symbols.size()]);
+
+    std::vector <dense_symbol_type> dense;
+    dense.reserve (queries.size());
+    benchmark::measure (name + " get_dense", queries.size(), repetitions,
+        [&]() {
+            dense.clear();
+            for (Symbol const & query : queries)
+                dense.push_back (alphabet.get_dense (query));
+            benchmark::keep (dense.back());
+        });
+
+    std::unique_ptr <bool []> missing (new bool [queries.size()]);
+    benchmark::measure (name + " get_dense range", queries.size(),
+        repetitions, [&]() {
+            benchmark::keep (alphabet.get_dense (
+                queries, dense.data(), missing.get()));
+        });
+
+    benchmark::measure (name + " get_symbol", dense.size(), repetitions,
+        [&]() {
+            for (dense_symbol_type const & d : dense)
+                benchmark::keep (alphabet.template get_symbol <Symbol> (d));
+        });
+}
+
+template <class Symbol>
+    void benchmark_alphabet (std::string const & name,
+        std::vector <Symbol> const & symbols)
+{
+    benchmark_alphabet <Symbol, math::hashed_symbol_mapping> (
+        name + " hashed", symbols);
+    benchmark_alphabet <Symbol, math::ordered_symbol_mapping> (
+        name + " ordered", symbols);
+}
+
+/**
+Compare looking up words in a text by constructing a std::string for each and
+by looking them up as boost::string_ref.
+*/
+template <class SymbolMapping>
+    void benchmark_string_keys (std::string const & name,
+        std::vector <std::string> const & symbols)
+{
+    typedef math::alphabet <std::string, void, 0xFFFFFF7F, meta::vector<>,
+        0x80, SymbolMapping> alphabet_type;
+    alphabet_type alphabet;
+    alphabet.add_symbols (symbols);
+
+    // Words of different lengths, some too long for the small string
+    // optimisation, separated by spaces.
+    std::string text;
+    std::vector <boost::string_ref> keys;
+    std::vector <std::size_t> offsets;
+    for (std::size_t i = 0; i != symbols.size(); ++ i) {
+        offsets.push_back (text.size());
+        text += symbols [(i * 7919) % symbols.size()];
+        text += ' ';
+    }
+    offsets.push_back (text.size());
+    for (std::size_t i = 0; i + 1 != offsets.size(); ++ i)
+        keys.push_back (boost::string_ref (
+            text.data() + offsets [i], offsets [i + 1] - offsets [i] - 1));
+
+    benchmark::measure (name + " get_dense std::string", keys.size(), 20,
+        [&]() {
+            for (boost::string_ref key : keys)
+                benchmark::keep (alphabet.get_dense (
+                    std::string (key.data(), key.size())));
+        });
+    benchmark::measure (name + " get_dense string_ref", keys.size(), 20,
+        [&]() {
+            for (boost::string_ref key : keys)
+                benchmark::keep (alphabet.get_dense (key));
+        });
+}
+
+/**
+Compare opening an alphabet over a file with building it with add_symbol.
+*/
+void benchmark_mapped_alphabet (std::string const & name,
+    std::vector <std::string> const & symbols)
+{
+    typedef math::alphabet <std::string, void, 0xFFFFFF7F, meta::vector<>,
+        0x80, math::mapped_symbol_mapping> alphabet_type;
+    std::string const file_name = "benchmark-alphabet.tmp";
+    {
+        math::alphabet <std::string, void, 0xFFFFFF7F, meta::vector<>, 0x80,
+            math::hashed_symbol_mapping> original;
+        for (std::string const & symbol : symbols)
+            original.add_symbol (symbol);
+        math::write_alphabet_file (original, file_name);
+    }
+
+    // Opening the file takes constant time, so this reports the time per
+    // symbol in the file.
+    benchmark::measure (name + " open", symbols.size(), 20, [&]() {
+            alphabet_type alphabet (file_name);
+            benchmark::keep (alphabet.normal_symbol_num());
+        });
+
+    alphabet_type alphabet (file_name);
+    std::vector <std::string> queries;
+    for (std::size_t i = 0; i != symbols.size(); ++ i)
+        queries.push_back (symbols [(i * 7919) % symbols.size()]);
+    benchmark::measure (name + " get_dense", queries.size(), 20, [&]() {
+            for (std::string const & query : queries)
+                benchmark::keep (alphabet.get_dense (query));
+        });
+    std::vector <alphabet_type::dense_symbol_type> dense (queries.size());
+    std::unique_ptr <bool []> missing (new bool [queries.size()]);
+    benchmark::measure (name + " get_dense range", queries.size(), 20, [&]() {
+            benchmark::keep (alphabet.get_dense (
+                queries, dense.data(), missing.get()));
+        });
+    std::remove (file_name.c_str());
+}
+
+int main() {
+    std::size_t const size = 1 << 16;
+
+    std::vector <int> integers;
+    for (std::size_t i = 0; i != size; ++ i)
+        integers.push_back (int (i * 2654435761u));
+    benchmark_alphabet ("alphabet<int>", integers);
+
+    std::vector <std::string> words;
+    for (std::size_t i = 0; i != size; ++ i)
+        words.push_back ("word" + std::to_string (i * 40503u % 1000003));
+    benchmark_alphabet ("alphabet<std::string>", words);
+
+    std::vector <std::string> long_words;
+    for (std::size_t i = 0; i != size; ++ i)
+        long_words.push_back (std::string (i % 24, 'w')
+            + std::to_string (i * 40503u % 1000003));
+    benchmark_string_keys <math::hashed_symbol_mapping> (
+        "alphabet<std::string> hashed", long_words);
+    benchmark_string_keys <math::ordered_symbol_mapping> (
+        "alphabet<std::string> ordered", long_words);
+
+    // A vocabulary of a million words does not fit in the cache.
+    std::size_t const large_size = 1 << 20;
+    std::vector <std::string> large_words;
+    for (std::size_t i = 0; i != large_size; ++ i)
+        large_words.push_back (
+            "word" + std::to_string (i * 40503u % 1048583));
+    benchmark_alphabet ("alphabet<std::string> 1M", large_words);
+    benchmark_mapped_alphabet ("alphabet<std::string> 1M mapped", large_words);
+    return 0;
+}
@@ -0,0 +1,61 @@
+/*
+Copyright 2026 Rogier van Dalen.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+/** \file
+Measure the speed of operations on the lexicographical semiring over a cost and
+a sequence, which is what a shortest-path search with output symbols uses.
+*/
+
+#include "math/lexicographical.hpp"
+
+#include <vector>
+#include <string>
+
+#include "math/cost.hpp"
+#include "math/sequence.hpp"
+
+#include "benchmark.hpp"
+
+typedef math::lexicographical <
+    math::over <math::cost <float>, math::sequence <char>>> lexicographical;
+
+lexicographical make_lexicographical (std::size_t seed, std::size_t length) {
+    std::string symbols;
+    for (std::size_t i = 0; i != length; ++ i)
+        symbols.push_back (char ('a' + (seed + i) % 3));
+    // Make costs collide sometimes, so that the sequences are compared.
+    return lexicographical (math::cost <float> (float (seed % 5)),
+        math::sequence <char> (symbols));
+}
+
+int main() {
+    std::size_t const size = 1 << 14;
+    std::size_t const repetitions = 20;
+
+    std::vector <lexicographical> left, right;
+    for (std::size_t i = 0; i != size; ++ i) {
+        left.push_back (make_lexicographical (i, i % 11));
+        right.push_back (make_lexicographical (i * 3, (i * 5) % 7));
+    }
+
+    std::string const name = "lexicographical<cost<float>, sequence<char>>";
+    benchmark::measure_binary (name + " choose", left, right,
+        math::choose, repetitions);
+    benchmark::measure_binary (name + " times", left, right,
+        math::times, repetitions);
+    benchmark::measure_binary (name + " plus", left, right,
+        math::plus, repetitions);
+    return 0;
+}
@@ -0,0 +1,66 @@
+/*
+Copyright 2026 Rogier van Dalen.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+/** \file
+Compare the speed of exact addition of log_float against addition with a
+low-precision policy, which uses a table.
+*/
+
+#include "math/log-float.hpp"
+#include "math/log-float_array.hpp"
+
+#include <vector>
+#include <string>
+
+#include "benchmark.hpp"
+
+template <class LogFloat>
+    void benchmark_addition (std::string const & name, std::size_t size)
+{
+    std::vector <LogFloat> left, right, result (size);
+    for (std::size_t i = 0; i != size; ++ i) {
+        left.push_back (LogFloat (-.5 * (i % 97), math::as_exponent()));
+        right.push_back (LogFloat (-.25 * (i % 89), math::as_exponent()));
+    }
+    std::size_t const repetitions = 100;
+
+    double scalar = benchmark::time_per_call ([&]() {
+            for (std::size_t i = 0; i != size; ++ i)
+                result [i] = left [i] + right [i];
+            benchmark::keep (result [size / 2]);
+        }, repetitions);
+    benchmark::report (name + " operator+", scalar, size);
+
+    double array = benchmark::time_per_call ([&]() {
+            math::add (left.data(), left.data() + size, right.data(),
+                result.data());
+            benchmark::keep (result [size / 2]);
+        }, repetitions);
+    benchmark::report (name + " math::add", array, size);
+}
+
+int main() {
+    std::size_t const size = 1 << 16;
+    benchmark_addition <math::log_float <double>> (
+        "log_float<double> exact", size);
+    benchmark_addition <math::log_float <double,
+        math::table_addition_policy<>>> ("log_float<double> table", size);
+    benchmark_addition <math::log_float <float>> (
+        "log_float<float> exact", size);
+    benchmark_addition <math::log_float <float,
+        math::table_addition_policy<>>> ("log_float<float> table", size);
+    return 0;
+}
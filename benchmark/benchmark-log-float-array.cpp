@@ -0,0 +1,108 @@
+/*
+Copyright 2026 Rogier van Dalen.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+/** \file
+Compare the speed of the array operations on log_float against loops over the
+scalar operations.
+*/
+
+#include "math/log-float_array.hpp"
+
+#include <vector>
+#include <string>
+
+#include "benchmark.hpp"
+
+template <class LogFloat>
+    void benchmark_add (std::string const & name, std::size_t size)
+{
+    std::vector <LogFloat> left, right, result (size);
+    for (std::size_t i = 0; i != size; ++ i) {
+        left.push_back (LogFloat (-.5 * (i % 97), math::as_exponent()));
+        right.push_back (LogFloat (-.25 * (i % 89), math::as_exponent()));
+    }
+    std::size_t const repetitions = 100;
+
+    double scalar = benchmark::time_per_call ([&]() {
+            for (std::size_t i = 0; i != size; ++ i)
+                result [i] = left [i] + right [i];
+            benchmark::keep (result [size / 2]);
+        }, repetitions);
+    benchmark::report (name + " operator+", scalar, size);
+
+    double array = benchmark::time_per_call ([&]() {
+            math::add (left.data(), left.data() + size, right.data(),
+                result.data());
+            benchmark::keep (result [size / 2]);
+        }, repetitions);
+    benchmark::report (name + " math::add", array, size);
+}
+
+template <class LogFloat>
+    void benchmark_conversion (std::string const & name, std::size_t size)
+{
+    typedef typename LogFloat::exponent_type exponent_type;
+    std::vector <exponent_type> values, linear (size);
+    for (std::size_t i = 0; i != size; ++ i)
+        values.push_back (exponent_type (i % 101) / 100);
+    std::vector <LogFloat> result (size);
+    std::size_t const repetitions = 100;
+
+    double scalar = benchmark::time_per_call ([&]() {
+            for (std::size_t i = 0; i != size; ++ i)
+                result [i] = LogFloat (values [i]);
+            benchmark::keep (result [size / 2]);
+        }, repetitions);
+    benchmark::report (name + " constructor", scalar, size);
+
+    double array = benchmark::time_per_call ([&]() {
+            math::to_log_float (values.data(), values.data() + size,
+                result.data());
+            benchmark::keep (result [size / 2]);
+        }, repetitions);
+    benchmark::report (name + " math::to_log_float", array, size);
+
+    double scalar_back = benchmark::time_per_call ([&]() {
+            for (std::size_t i = 0; i != size; ++ i)
+                linear [i] = result [i].get();
+            benchmark::keep (linear [size / 2]);
+        }, repetitions);
+    benchmark::report (name + " get", scalar_back, size);
+
+    double array_back = benchmark::time_per_call ([&]() {
+            math::from_log_float (result.data(), result.data() + size,
+                linear.data());
+            benchmark::keep (linear [size / 2]);
+        }, repetitions);
+    benchmark::report (name + " math::from_log_float", array_back, size);
+}
+
+int main() {
+    using boost::math::policies::policy;
+    using boost::math::policies::overflow_error;
+    using boost::math::policies::ignore_error;
+    typedef policy <overflow_error <ignore_error>> ignore_overflow;
+
+    std::size_t const size = 1 << 16;
+    benchmark_add <math::log_float <float>> ("log_float<float>", size);
+    benchmark_add <math::log_float <double>> ("log_float<double>", size);
+    benchmark_add <math::log_float <double, ignore_overflow>> (
+        "log_float<double, ignore overflow>", size);
+
+    benchmark_conversion <math::log_float <float>> ("log_float<float>", size);
+    benchmark_conversion <math::log_float <double>> ("log_float<double>", size);
+    return 0;
+}
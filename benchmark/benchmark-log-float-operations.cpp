@@ -0,0 +1,83 @@
+/*
+Copyright 2026 Rogier van Dalen.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+/** \file
+Measure the speed of the arithmetic operations on log_float and
+signed_log_float under different error policies.
+*/
+
+#include "math/log-float.hpp"
+
+#include <limits>
+#include <vector>
+#include <string>
+
+#include "benchmark.hpp"
+
+template <class LogFloat>
+    void benchmark_operations (std::string const & name, std::size_t size)
+{
+    typedef typename LogFloat::exponent_type exponent_type;
+    // For signed_log_float, make a third of the left operands negative.
+    bool const is_signed = std::numeric_limits <LogFloat>::is_signed;
+    std::vector <LogFloat> left, right;
+    for (std::size_t i = 0; i != size; ++ i) {
+        exponent_type sign = (is_signed && i % 3 == 0) ? -1 : 1;
+        left.push_back (LogFloat (sign * exponent_type ((i * 7) % 97 + 1)));
+        right.push_back (LogFloat (exponent_type ((i * 11) % 89 + 1) / 16));
+    }
+    std::size_t const repetitions = 100;
+
+    benchmark::measure_binary (name + " +", left, right,
+        [] (LogFloat const & a, LogFloat const & b) { return a + b; },
+        repetitions);
+    benchmark::measure_binary (name + " *", left, right,
+        [] (LogFloat const & a, LogFloat const & b) { return a * b; },
+        repetitions);
+    benchmark::measure_binary (name + " /", left, right,
+        [] (LogFloat const & a, LogFloat const & b) { return a / b; },
+        repetitions);
+}
+
+template <class Exponent, class Policy>
+    void benchmark_policy (std::string const & exponent_name,
+        std::string const & policy_name, std::size_t size)
+{
+    benchmark_operations <math::log_float <Exponent, Policy>> (
+        "log_float<" + exponent_name + ", " + policy_name + ">", size);
+    benchmark_operations <math::signed_log_float <Exponent, Policy>> (
+        "signed_log_float<" + exponent_name + ", " + policy_name + ">", size);
+}
+
+int main() {
+    using boost::math::policies::policy;
+    using boost::math::policies::domain_error;
+    using boost::math::policies::overflow_error;
+    using boost::math::policies::underflow_error;
+    using boost::math::policies::ignore_error;
+    typedef policy <domain_error <ignore_error>, overflow_error <ignore_error>,
+        underflow_error <ignore_error>> ignore_errors;
+    typedef math::table_addition_policy<> table_addition;
+
+    std::size_t const size = 1 << 16;
+    benchmark_policy <float, policy<>> ("float", "default", size);
+    benchmark_policy <float, ignore_errors> ("float", "ignore errors", size);
+    benchmark_policy <float, table_addition> ("float", "table", size);
+    benchmark_policy <double, policy<>> ("double", "default", size);
+    benchmark_policy <double, ignore_errors> ("double", "ignore errors", size);
+    benchmark_policy <double, table_addition> ("double", "table", size);
+    return 0;
+}
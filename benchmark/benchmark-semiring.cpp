@@ -0,0 +1,61 @@
+/*
+Copyright 2026 Rogier van Dalen.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+/** \file
+Measure the speed of the operations of the semirings that are based on a single
+number: cost and max_semiring.
+*/
+
+#include "math/cost.hpp"
+#include "math/max_semiring.hpp"
+
+#include <vector>
+#include <string>
+#include <type_traits>
+#include <utility>
+
+#include "benchmark.hpp"
+
+template <class Semiring>
+    void benchmark_semiring (std::string const & name, std::size_t size)
+{
+    typedef typename std::decay <decltype (std::declval <Semiring>().value())
+        >::type value_type;
+    std::size_t const repetitions = 100;
+
+    std::vector <Semiring> left, right;
+    for (std::size_t i = 0; i != size; ++ i) {
+        left.push_back (Semiring (value_type ((i * 7) % 97 + 1) / 8));
+        right.push_back (Semiring (value_type ((i * 11) % 89 + 1) / 8));
+    }
+
+    benchmark::measure_binary (name + " times", left, right,
+        math::times, repetitions);
+    benchmark::measure_binary (name + " plus", left, right,
+        math::plus, repetitions);
+    benchmark::measure_binary (name + " choose", left, right,
+        math::choose, repetitions);
+}
+
+int main() {
+    std::size_t const size = 1 << 16;
+    benchmark_semiring <math::cost <float>> ("cost<float>", size);
+    benchmark_semiring <math::cost <double>> ("cost<double>", size);
+    benchmark_semiring <math::max_semiring <float>> (
+        "max_semiring<float>", size);
+    benchmark_semiring <math::max_semiring <double>> (
+        "max_semiring<double>", size);
+    return 0;
+}
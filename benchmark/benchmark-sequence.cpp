@@ -0,0 +1,72 @@
+/*
+Copyright 2026 Rogier van Dalen.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+/** \file
+Measure the speed of operations on sequences.
+*/
+
+#include "math/sequence.hpp"
+
+#include <vector>
+#include <string>
+#include <type_traits>
+
+#include "benchmark.hpp"
+
+/**
+Make a string of \a length symbols from a small alphabet, so that strings often
+share prefixes and suffixes.
+*/
+std::string make_symbols (std::size_t seed, std::size_t length) {
+    std::string symbols;
+    for (std::size_t i = 0; i != length; ++ i)
+        symbols.push_back (char ('a' + (seed * 31 + i * (seed % 3)) % 4));
+    return symbols;
+}
+
+template <class Direction>
+    void benchmark_sequence (std::string const & name, std::size_t size)
+{
+    typedef math::sequence <char, Direction> sequence;
+    std::size_t const repetitions = 20;
+
+    std::vector <sequence> left, right, whole, part;
+    for (std::size_t i = 0; i != size; ++ i) {
+        std::string left_symbols = make_symbols (i, i % 17);
+        std::string right_symbols = make_symbols (i / 2, (i * 7) % 13);
+        left.push_back (sequence (left_symbols));
+        right.push_back (sequence (right_symbols));
+
+        // For division, "part" is a prefix (or suffix) of "whole".
+        std::string whole_symbols = left_symbols + right_symbols;
+        whole.push_back (sequence (whole_symbols));
+        part.push_back (sequence (std::is_same <Direction, math::left>::value
+            ? left_symbols : right_symbols));
+    }
+
+    benchmark::measure_binary (name + " times", left, right,
+        math::times, repetitions);
+    benchmark::measure_binary (name + " plus", left, right,
+        math::plus, repetitions);
+    benchmark::measure_binary (name + " divide", whole, part,
+        math::callable::divide <Direction>(), repetitions);
+}
+
+int main() {
+    std::size_t const size = 1 << 14;
+    benchmark_sequence <math::left> ("sequence<char, left>", size);
+    benchmark_sequence <math::right> ("sequence<char, right>", size);
+    return 0;
+}
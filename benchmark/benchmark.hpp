@@ -0,0 +1,117 @@
+/*
+Copyright 2026 Rogier van Dalen.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+/** \file
+Minimal helpers for timing benchmarks.
+
+The output is meant to be read by programs, to track performance regressions.
+Each measurement is written as one line with three fields separated by tabs:
+the name of the benchmark, the time per element in nanoseconds, and the number
+of elements processed per call.
+Names do not contain tabs.
+*/
+
+#ifndef MATH_BENCHMARK_BENCHMARK_HPP_INCLUDED
+#define MATH_BENCHMARK_BENCHMARK_HPP_INCLUDED
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <iostream>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+namespace benchmark {
+
+    /**
+    Prevent the compiler from optimising away the computation of \a value.
+    */
+    template <class Type> inline void keep (Type const & value) {
+        static Type volatile const * volatile sink;
+        sink = &value;
+        (void) sink;
+    }
+
+    /**
+    Call \a function \a repetitions times, and return the average time per
+    call in nanoseconds.
+    The function is called once before the timing starts, to warm up caches.
+    */
+    template <class Function>
+        inline double time_per_call (Function && function,
+            std::size_t repetitions)
+    {
+        typedef std::chrono::steady_clock clock;
+        function();
+        clock::time_point start = clock::now();
+        for (std::size_t repetition = 0; repetition != repetitions;
+                ++ repetition)
+            function();
+        clock::time_point end = clock::now();
+        return std::chrono::duration <double, std::nano> (end - start).count()
+            / repetitions;
+    }
+
+    /**
+    Report the time that one operation on one element takes.
+    */
+    inline void report (std::string const & name, double nanoseconds_per_call,
+        std::size_t elements_per_call)
+    {
+        std::cout << name << '\t'
+            << nanoseconds_per_call / elements_per_call << '\t'
+            << elements_per_call << std::endl;
+    }
+
+    /**
+    Time \a function, which processes \a elements_per_call elements, and report
+    the time per element.
+    */
+    template <class Function>
+        inline void measure (std::string const & name,
+            std::size_t elements_per_call, std::size_t repetitions,
+            Function && function)
+    {
+        report (name, time_per_call (function, repetitions),
+            elements_per_call);
+    }
+
+    /**
+    Time applying \a operation to corresponding elements of \a left and
+    \a right, and report the time per element.
+    */
+    template <class Left, class Right, class Operation>
+        inline void measure_binary (std::string const & name,
+            std::vector <Left> const & left, std::vector <Right> const & right,
+            Operation const & operation, std::size_t repetitions)
+    {
+        typedef typename std::decay <decltype (
+            operation (left.front(), right.front()))>::type result_type;
+        std::size_t size = (std::min) (left.size(), right.size());
+        std::vector <result_type> result;
+        result.reserve (size);
+        measure (name, size, repetitions, [&]() {
+                result.clear();
+                for (std::size_t i = 0; i != size; ++ i)
+                    result.push_back (operation (left [i], right [i]));
+                keep (result.back());
+            });
+    }
+
+} // namespace benchmark
+
+#endif // MATH_BENCHMARK_BENCHMARK_HPP_INCLUDED
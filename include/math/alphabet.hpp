@@ -17,17 +17,23 @@ limitations under the License.
 #ifndef MATH_ALPHABET_HPP_INCLUDED
 #define MATH_ALPHABET_HPP_INCLUDED
 
+#include <atomic>
 #include <memory>
+#include <mutex>
+#include <string>
 #include <type_traits>
 #include <limits>
 #include <cstdint>
+#include <iterator>
+#include <vector>
 
 #include <boost/mpl/placeholders.hpp>
 #include <boost/mpl/bool.hpp>
 #include <boost/mpl/pair.hpp>
 
 #include <boost/bimap.hpp>
-#include <boost/functional/hash_fwd.hpp>
+#include <boost/functional/hash.hpp>
+#include <boost/utility/string_ref.hpp>
 
 #include "utility/returns.hpp"
 
@@ -39,8 +45,53 @@ limitations under the License.
 #include "rime/core.hpp"
 #include "rime/assert.hpp"
 
+#include "detail/append_only_array.hpp"
+#include "detail/common_length.hpp"
+
 namespace math {
 
+/** \struct hashed_symbol_mapping
+Select a hash table to map normal symbols in an alphabet to dense symbols, and
+an array to map dense symbols back.
+The normal symbol type must support boost::hash and \c operator==.
+The hash table uses open addressing, so that a lookup normally touches only one
+or two cache lines.
+Looking up symbols never blocks, not even while another thread adds a symbol.
+References to normal symbols that the alphabet returns remain valid as long as
+the alphabet exists.
+If the normal symbol type is \c std::string, symbols can be looked up with
+\c boost::string_ref without constructing a \c std::string.
+Each symbol is stored as a \c std::string, because get_symbol() returns a
+reference to one.
+For an alphabet that does not fit in memory, or that many processes share,
+use mapped_symbol_mapping, which keeps the bytes of the symbols together in a
+file.
+This class is used only at compile-time and remains incomplete.
+*/
+struct hashed_symbol_mapping;
+
+/** \struct ordered_symbol_mapping
+Select an ordered, node-based, bidirectional map (boost::bimap) to map normal
+symbols in an alphabet to dense symbols and back.
+The normal symbol type must support \c operator<.
+This does not lock: if one thread adds symbols while other threads use the
+alphabet, the caller must synchronise them.
+This class is used only at compile-time and remains incomplete.
+*/
+struct ordered_symbol_mapping;
+
+/** \struct mapped_symbol_mapping
+Select a read-only file, mapped into memory, for the normal symbols that an
+alphabet starts with, and a hashed_symbol_mapping for normal symbols that are
+added later.
+The normal symbol type must be \c std::string.
+The alphabet must be constructed with the name of a file that
+write_alphabet_file has written.
+This requires header \c math/mapped_alphabet.hpp.
+This class is used only at compile-time and remains incomplete.
+*/
+struct mapped_symbol_mapping;
+
 /** \class alphabet
 \brief Alphabet of symbols.
 
@@ -64,6 +115,10 @@ By default, space is reserved in a 32-bit integer with 128 special symbols.
 Normal symbols are added to an alphabet at run time.
 To make sure that they cannot be accidentally re-used, symbols cannot be removed
 from an alphabet.
+With hashed_symbol_mapping, any number of threads can look up symbols while
+other threads add symbols.
+References to normal symbols that the alphabet returns remain valid as long as
+the alphabet exists.
 
 Special symbols are added at compile time, as it were, with the
 add_special_symbol function, which returns the alphabet with the extra special
@@ -86,11 +141,16 @@ to it.
 \tparam special_symbol_headroom
     The maximum number of special symbols.
     The default value is 128.
+\tparam SymbolMapping
+    The data structure that maps normal symbols to dense symbols and back:
+    ordered_symbol_mapping (the default), hashed_symbol_mapping, or
+    mapped_symbol_mapping.
 */
 template <class NormalSymbol, class Tag = void,
     std::size_t max_normal_symbol_num = 0xFFFFFF7F,
     class SpecialSymbols = meta::vector<>,
-    std::size_t special_symbol_headroom = 0x80>
+    std::size_t special_symbol_headroom = 0x80,
+    class SymbolMapping = ordered_symbol_mapping>
 class alphabet;
 
 /**
@@ -131,6 +191,10 @@ public:
     Symbol const & symbol() const { return symbol_; }
 };
 
+namespace detail {
+    struct dense_symbol_access;
+} // namespace detail
+
 /**
 Represent a symbol from an alphabet with an integer.
 There is usually no reason to explicitly use this class; \a alphabet will
@@ -165,8 +229,10 @@ public:
 private:
     template <class NormalSymbol, class Tag2,
         std::size_t max_normal_symbol_num,
-        class SpecialSymbols, std::size_t special_symbol_headroom>
+        class SpecialSymbols, std::size_t special_symbol_headroom,
+        class SymbolMapping>
     friend class alphabet;
+    friend struct detail::dense_symbol_access;
 
     explicit dense_symbol (Value const & id)
     : id_ (id) {}
@@ -250,6 +316,23 @@ template <class Value, class Tag>
 
 namespace detail {
 
+    // Dense symbols with run-time ids compare equal iff their ids do.
+    template <class Value, class Tag>
+        struct is_bitwise_comparable <dense_symbol <Value, Tag>,
+            typename std::enable_if <std::is_integral <Value>::value>::type>
+    : std::integral_constant <bool,
+        sizeof (dense_symbol <Value, Tag>) == sizeof (Value)> {};
+
+    /**
+    Construct dense symbols from their ids, for classes that store the ids in a
+    different form, like packed_sequence.
+    */
+    struct dense_symbol_access {
+        template <class Value, class Tag> static dense_symbol <Value, Tag>
+            make (Value const & id)
+        { return dense_symbol <Value, Tag> (id); }
+    };
+
     typedef meta::vector <std::int_least8_t, std::int_least16_t,
             std::int_least32_t, std::int_least64_t, std::intmax_t>
         possible_dense_types;
@@ -282,22 +365,122 @@ namespace detail {
         typedef typename meta::first <possible_types>::type type;
     };
 
+    /**
+    Hint to the processor that the memory at \a address will be read soon.
+    */
+    inline void prefetch (void const * address) {
+#if defined (__GNUC__)
+        __builtin_prefetch (address);
+#else
+        (void) address;
+#endif
+    }
+
+    /**
+    Number of symbols that the bulk operations on alphabets hash before they
+    look any of them up.
+    The memory in the hash table that the lookups need is prefetched while the
+    next symbols are hashed.
+    */
+    static std::size_t constexpr symbol_batch_size = 16;
+
     /**
     Mapping of the symbol type to the dense symbol type.
+    Apart from the operations on single symbols, each mapping provides the
+    operations that the bulk operations on alphabets use: hash(), prefetch(),
+    find(), which does not throw, and add() for an array of symbols that were
+    not found.
+    \tparam SymbolMapping
+        hashed_symbol_mapping, ordered_symbol_mapping, or
+        mapped_symbol_mapping.
+    */
+    template <class Symbol, class DenseValue, class SymbolMapping>
+        struct normal_symbol_mapping;
+
+    /**
+    Describe the keys that normal symbols of type \a Symbol can be looked up
+    with.
+    By default, this is only \a Symbol itself.
+    The symbol mappings receive keys of type \a Symbol or \c type.
     */
+    template <class Symbol> struct symbol_key {
+        /// Whether \a Key can be used to look up symbols, apart from
+        /// \a Symbol.
+        template <class Key> struct is_key : std::false_type {};
+
+        /// The type that keys are converted to before they are looked up.
+        typedef Symbol const & type;
+
+        static std::size_t hash (Symbol const & symbol)
+        { return boost::hash <Symbol>() (symbol); }
+
+        static Symbol const & to_symbol (Symbol const & symbol)
+        { return symbol; }
+    };
+
+    /**
+    Strings can be looked up with anything that converts to
+    \c boost::string_ref, like \c char \c const \c *, without constructing a
+    \c std::string.
+    */
+    template <> struct symbol_key <std::string> {
+        template <class Key> struct is_key
+        : std::integral_constant <bool,
+            std::is_convertible <Key const &, boost::string_ref>::value
+            && !std::is_same <Key, std::string>::value> {};
+
+        typedef boost::string_ref type;
+
+        // This takes std::string as well.
+        static std::size_t hash (boost::string_ref key)
+        { return boost::hash_range (key.begin(), key.end()); }
+
+        static std::string const & to_symbol (std::string const & symbol)
+        { return symbol; }
+
+        static std::string to_symbol (boost::string_ref key)
+        { return std::string (key.data(), key.size()); }
+    };
+
     template <class Symbol, class DenseValue>
-        struct normal_symbol_mapping
+        struct normal_symbol_mapping <Symbol, DenseValue,
+            ordered_symbol_mapping>
     {
         DenseValue symbol_num;
         DenseValue max_symbol_num;
 
         typedef boost::bimap <Symbol, DenseValue> mapping_type;
         mapping_type mapping;
+
     public:
+        // The map does not use hash values.
+        typedef std::size_t hash_type;
+
         normal_symbol_mapping (DenseValue max_symbol_num)
         : symbol_num (0), max_symbol_num (max_symbol_num) {}
 
-        DenseValue get_dense (Symbol const & symbol) const {
+        std::size_t size() const { return symbol_num; }
+
+        DenseValue add (Symbol const & symbol) {
+            auto symbol_mapping = mapping.left.find (symbol);
+            if (symbol_mapping != mapping.left.end()) {
+                // The symbol is already in the map.
+                return symbol_mapping->second;
+            } else {
+                if (symbol_num == max_symbol_num)
+                    throw alphabet_overflow();
+                DenseValue new_value (symbol_num);
+                ++ symbol_num;
+                mapping.insert (typename mapping_type::value_type (
+                    symbol, new_value));
+                return new_value;
+            }
+        }
+
+        // The bimap cannot look up keys of other types than Symbol, so they
+        // are converted.
+        template <class Key> DenseValue get_dense (Key const & key) const {
+            auto && symbol = symbol_key <Symbol>::to_symbol (key);
             auto symbol_mapping = mapping.left.find (symbol);
             if (symbol_mapping != mapping.left.end()) {
                 // The symbol is in the map.
@@ -317,23 +500,280 @@ namespace detail {
                 throw symbol_not_found_of <DenseValue> (dense_symbol);
         }
 
-        DenseValue add (Symbol const & symbol) {
+        template <class Key> hash_type hash (Key const &) const { return 0; }
+
+        void prefetch (hash_type) const {}
+
+        template <class Key>
+            bool find (Key const & key, hash_type, DenseValue & dense) const
+        {
+            auto && symbol = symbol_key <Symbol>::to_symbol (key);
             auto symbol_mapping = mapping.left.find (symbol);
-            if (symbol_mapping != mapping.left.end()) {
-                // The symbol is already in the map.
-                return symbol_mapping->second;
-            } else {
-                if (symbol_num == max_symbol_num)
-                    throw alphabet_overflow();
-                DenseValue new_value (symbol_num);
-                ++ symbol_num;
-                mapping.insert (typename mapping_type::value_type (
-                    symbol, new_value));
-                return new_value;
+            if (symbol_mapping == mapping.left.end())
+                return false;
+            dense = symbol_mapping->second;
+            return true;
+        }
+
+        void add (Symbol const * const * new_symbols, hash_type const *,
+            std::size_t num, DenseValue * result)
+        {
+            for (std::size_t index = 0; index != num; ++ index)
+                result [index] = add (*new_symbols [index]);
+        }
+    };
+
+    /**
+    Hash table with open addressing and linear probing.
+    The symbols are kept in an append_only_array, in the order of their dense
+    values, so that references to them remain valid when symbols are added.
+    The table contains, for each symbol, its hash value and its dense value.
+    Only if the hash values are equal are the symbols themselves compared.
+    The number of slots is a power of two, and the table is kept at most half
+    full.
+
+    Any number of threads can look up symbols without locking, also while
+    another thread adds a symbol.
+    Threads that add symbols take turns, using a mutex.
+    A slot is filled by first writing the hash value and then, atomically, the
+    dense value, so that readers see either an empty slot or a complete one.
+    When the table grows, a new table is filled and then published.
+    The old tables are kept until the mapping is destructed, because readers
+    may still be looking at them.
+    Since each table is twice the size of the previous one, this takes at most
+    as much memory as the current table.
+    */
+    template <class Symbol, class DenseValue>
+        class normal_symbol_mapping <Symbol, DenseValue, hashed_symbol_mapping>
+    {
+        // Dense value that indicates an empty slot.
+        // The alphabet never uses it for a normal symbol.
+        static DenseValue constexpr empty_slot =
+            std::numeric_limits <DenseValue>::max();
+
+        static std::size_t constexpr initial_slot_num = 16;
+
+        struct slot {
+            std::size_t hash;
+            std::atomic <DenseValue> dense;
+        };
+
+        struct table {
+            std::size_t mask;
+            std::unique_ptr <slot []> slots;
+
+            explicit table (std::size_t slot_num)
+            : mask (slot_num - 1), slots (new slot [slot_num]) {
+                for (std::size_t position = 0; position != slot_num;
+                        ++ position)
+                    slots [position].dense.store (
+                        empty_slot, std::memory_order_relaxed);
+            }
+
+            std::size_t slot_num() const { return mask + 1; }
+        };
+
+        DenseValue max_symbol_num;
+        append_only_array <Symbol> symbols;
+
+        std::atomic <table const *> current_table;
+        // All tables, including the current one.
+        std::vector <std::unique_ptr <table>> tables;
+        std::mutex add_mutex;
+
+        template <class Key> static std::size_t hash_symbol (Key const & key)
+        { return symbol_key <Symbol>::hash (key); }
+
+        /**
+        Return the first slot to look in.
+        Hash functions often do not spread out values in the lower bits (the
+        hash of an integer is often the integer itself), so the bits are mixed
+        first.
+        */
+        static std::size_t first_position (
+            table const & t, std::size_t hash)
+        {
+            std::uint64_t mixed = std::uint64_t (hash) * 0x9E3779B97F4A7C15ull;
+            return std::size_t (mixed ^ (mixed >> 32)) & t.mask;
+        }
+
+        /**
+        Look for \a key in \a t.
+        \param position
+            Set to the position of the slot that contains \a key, or if it is
+            not in the table, of the empty slot where it would go.
+        \return The dense value of the symbol, or \c empty_slot.
+        */
+        template <class Key> DenseValue look_up (table const & t,
+            Key const & key, std::size_t hash, std::size_t & position) const
+        {
+            position = first_position (t, hash);
+            while (true) {
+                slot const & current = t.slots [position];
+                DenseValue dense = current.dense.load (
+                    std::memory_order_acquire);
+                if (dense == empty_slot)
+                    return empty_slot;
+                if (current.hash == hash && symbols [dense] == key)
+                    return dense;
+                position = (position + 1) & t.mask;
+            }
+        }
+
+        template <class Key>
+            DenseValue look_up (Key const & key, std::size_t hash) const
+        {
+            std::size_t position;
+            return look_up (*current_table.load (std::memory_order_acquire),
+                key, hash, position);
+        }
+
+        /**
+        Publish a table with \a slot_num slots, which must be a power of two
+        greater than the number of slots in \a old_table.
+        \pre The caller holds \c add_mutex.
+        */
+        table const & grow (table const & old_table, std::size_t slot_num) {
+            std::unique_ptr <table> new_table (new table (slot_num));
+            for (std::size_t old_position = 0;
+                old_position != old_table.slot_num(); ++ old_position)
+            {
+                slot const & old_slot = old_table.slots [old_position];
+                DenseValue dense = old_slot.dense.load (
+                    std::memory_order_relaxed);
+                if (dense != empty_slot) {
+                    std::size_t position = first_position (
+                        *new_table, old_slot.hash);
+                    while (new_table->slots [position].dense.load (
+                            std::memory_order_relaxed) != empty_slot)
+                        position = (position + 1) & new_table->mask;
+                    new_table->slots [position].hash = old_slot.hash;
+                    new_table->slots [position].dense.store (
+                        dense, std::memory_order_relaxed);
+                }
             }
+            tables.push_back (std::move (new_table));
+            current_table.store (tables.back().get(),
+                std::memory_order_release);
+            return *tables.back();
+        }
+
+        /**
+        Add \a symbol if it is not in the table yet.
+        \pre The caller holds \c add_mutex.
+        */
+        DenseValue add_locked (Symbol const & symbol, std::size_t hash) {
+            table const * t = current_table.load (std::memory_order_relaxed);
+            std::size_t position;
+            DenseValue existing = look_up (*t, symbol, hash, position);
+            if (existing != empty_slot)
+                return existing;
+
+            std::size_t symbol_num = symbols.size();
+            if (symbol_num == max_symbol_num)
+                throw alphabet_overflow();
+            if (2 * (symbol_num + 1) > t->slot_num()) {
+                t = &grow (*t, 2 * t->slot_num());
+                look_up (*t, symbol, hash, position);
+            }
+            DenseValue new_value (symbol_num);
+            symbols.push_back (symbol);
+            slot & new_slot = t->slots [position];
+            new_slot.hash = hash;
+            new_slot.dense.store (new_value, std::memory_order_release);
+            return new_value;
+        }
+
+    public:
+        typedef std::size_t hash_type;
+
+        normal_symbol_mapping (DenseValue max_symbol_num)
+        : max_symbol_num (max_symbol_num)
+        {
+            tables.push_back (std::unique_ptr <table> (
+                new table (initial_slot_num)));
+            current_table.store (tables.back().get(),
+                std::memory_order_relaxed);
+        }
+
+        normal_symbol_mapping (normal_symbol_mapping const &) = delete;
+        normal_symbol_mapping & operator = (normal_symbol_mapping const &)
+            = delete;
+
+        std::size_t size() const { return symbols.size(); }
+
+        template <class Key> DenseValue get_dense (Key const & key) const {
+            DenseValue dense = look_up (key, hash_symbol (key));
+            if (dense != empty_slot)
+                return dense;
+            else
+                throw symbol_not_found_of <Symbol> (
+                    symbol_key <Symbol>::to_symbol (key));
+        }
+
+        Symbol const & get_symbol (DenseValue const & dense_symbol) const {
+            if (dense_symbol < symbols.size())
+                return symbols [dense_symbol];
+            else
+                throw symbol_not_found_of <DenseValue> (dense_symbol);
+        }
+
+        DenseValue add (Symbol const & symbol) {
+            std::size_t hash = hash_symbol (symbol);
+            // Most of the time, the symbol is already in the table, and there
+            // is no need to lock.
+            DenseValue existing = look_up (symbol, hash);
+            if (existing != empty_slot)
+                return existing;
+
+            std::lock_guard <std::mutex> lock (add_mutex);
+            // Another thread may have added the symbol in the meantime.
+            return add_locked (symbol, hash);
+        }
+
+        template <class Key> hash_type hash (Key const & key) const
+        { return hash_symbol (key); }
+
+        void prefetch (hash_type hash) const {
+            table const & t = *current_table.load (std::memory_order_acquire);
+            detail::prefetch (&t.slots [first_position (t, hash)]);
+        }
+
+        template <class Key>
+            bool find (Key const & key, hash_type hash, DenseValue & dense) const
+        {
+            dense = look_up (key, hash);
+            return dense != empty_slot;
+        }
+
+        /**
+        Add a number of symbols, taking the lock only once.
+        The table is first grown to fit all symbols, so that it does not need to
+        be rebuilt more than once.
+        */
+        void add (Symbol const * const * new_symbols, hash_type const * hashes,
+            std::size_t num, DenseValue * result)
+        {
+            std::lock_guard <std::mutex> lock (add_mutex);
+            table const & t = *current_table.load (std::memory_order_relaxed);
+            std::size_t symbol_num = symbols.size() + (std::min) (
+                num, std::size_t (max_symbol_num - symbols.size()));
+            std::size_t slot_num = t.slot_num();
+            while (2 * symbol_num > slot_num)
+                slot_num *= 2;
+            if (slot_num != t.slot_num())
+                grow (t, slot_num);
+
+            for (std::size_t index = 0; index != num; ++ index)
+                result [index] = add_locked (*new_symbols [index],
+                    hashes [index]);
         }
     };
 
+    template <class Symbol, class DenseValue>
+        DenseValue constexpr normal_symbol_mapping <
+            Symbol, DenseValue, hashed_symbol_mapping>::empty_slot;
+
     /**
     Provide implementations for methods of math::alphabet specialised for
     all special symbol types.
@@ -539,7 +979,8 @@ namespace detail {
 } // namespace detail
 
 template <class NormalSymbol, class Tag, std::size_t max_normal_symbol_num,
-    class SpecialSymbols, std::size_t special_symbol_headroom>
+    class SpecialSymbols, std::size_t special_symbol_headroom,
+    class SymbolMapping>
 class alphabet
 /// \cond DONT_DOCUMENT
 : public detail::handle_special_symbols <
@@ -580,8 +1021,8 @@ private:
     typedef detail::handle_special_symbols <dense_type, Tag,
         special_symbols> handle_special_symbols;
 
-    typedef detail::normal_symbol_mapping <NormalSymbol, unsigned_dense_type>
-        symbol_mapping_type;
+    typedef detail::normal_symbol_mapping <NormalSymbol, unsigned_dense_type,
+        SymbolMapping> symbol_mapping_type;
     std::shared_ptr <symbol_mapping_type> normal_symbol_mapping;
 
 public:
@@ -605,9 +1046,30 @@ public:
     : normal_symbol_mapping (
         std::make_shared <symbol_mapping_type> (max_normal_symbol_num)) {}
 
+    /**
+    Construct an alphabet with the normal symbols from a file that
+    write_alphabet_file has written.
+    The file is mapped into memory, so that the symbols are read only when they
+    are used, and processes that open the same file share the memory.
+    Symbols that are added later are not written to the file.
+    This is only available if \a SymbolMapping is mapped_symbol_mapping, and
+    requires header \c math/mapped_alphabet.hpp.
+    \throw alphabet_file_error if the file is not in the right format.
+    \throw alphabet_overflow if the file contains too many symbols.
+    */
+    template <class FileName,
+        /// \cond DONT_DOCUMENT
+        class Enable = typename std::enable_if <
+            std::is_same <SymbolMapping, mapped_symbol_mapping>::value
+            && std::is_convertible <FileName, std::string>::value>::type
+        /// \endcond
+    > explicit alphabet (FileName const & file_name)
+    : normal_symbol_mapping (std::make_shared <symbol_mapping_type> (
+        max_normal_symbol_num, std::string (file_name))) {}
+
     template <class SpecialSymbols2>
     alphabet (alphabet <NormalSymbol, Tag, max_normal_symbol_num,
-        SpecialSymbols2, special_symbol_headroom> const & other)
+        SpecialSymbols2, special_symbol_headroom, SymbolMapping> const & other)
     : normal_symbol_mapping (other.normal_symbol_mapping) {
         static_assert (detail::augments_special_symbols <
                 special_symbols, typename
@@ -626,6 +1088,69 @@ public:
         return dense_symbol_type (s);
     }
 
+    /**
+    Add a range of normal symbols to the alphabet.
+    This is faster than calling add_symbol() for each symbol.
+    The symbols are first looked up as by get_dense() for ranges.
+    The symbols that are not found are then added while holding the lock only
+    once.
+    Before they are added, the hash table is grown so it fits all of them.
+    Symbols that occur more than once are added only once.
+    \param symbols
+        A forward range of objects of type \c NormalSymbol, which must remain
+        valid while this function runs.
+    \param result
+        If this is not null, it must point to an array with room for one dense
+        symbol per element of \a symbols.
+        The dense symbol for each element is written there.
+    \throw alphabet_overflow if there is no room in the alphabet.
+        The symbols before the first one that did not fit have then been
+        added.
+    */
+    template <class Symbols>
+        void add_symbols (Symbols const & symbols,
+            dense_symbol_type * result = nullptr)
+    {
+        typedef decltype (*std::begin (symbols)) reference;
+        static_assert (std::is_lvalue_reference <reference>::value
+            && std::is_same <typename std::decay <reference>::type,
+                NormalSymbol>::value,
+            "The range must contain objects of the normal symbol type.");
+
+        typedef typename symbol_mapping_type::hash_type hash_type;
+        std::vector <NormalSymbol const *> new_symbols;
+        std::vector <hash_type> new_hashes;
+        std::vector <std::size_t> new_indices;
+        look_up_normal_symbols (symbols,
+            [&] (std::size_t index, unsigned_dense_type dense) {
+                if (result)
+                    result [index] = dense_symbol_type (dense_type (dense));
+            },
+            [&] (std::size_t index, reference symbol, hash_type hash) {
+                new_symbols.push_back (&symbol);
+                new_hashes.push_back (hash);
+                new_indices.push_back (index);
+            });
+        if (new_symbols.empty())
+            return;
+
+        std::vector <unsigned_dense_type> new_dense (new_symbols.size());
+        normal_symbol_mapping->add (new_symbols.data(), new_hashes.data(),
+            new_symbols.size(), new_dense.data());
+        if (result) {
+            for (std::size_t index = 0; index != new_dense.size(); ++ index)
+                result [new_indices [index]] =
+                    dense_symbol_type (dense_type (new_dense [index]));
+        }
+    }
+
+    /**
+    \return The number of normal symbols in the alphabet.
+    Their dense symbols have ids from 0 up to this number.
+    */
+    std::size_t normal_symbol_num() const
+    { return normal_symbol_mapping->size(); }
+
     // Pull in functions from base classes to deal with special symbols.
     using handle_special_symbols::get_dense;
     using handle_special_symbols::is_special_symbol;
@@ -644,6 +1169,69 @@ public:
         return dense_symbol_type (s);
     }
 
+    /**
+    \return The dense representation of a normal symbol, looked up with a key
+    of a type other than \c NormalSymbol.
+    If \c NormalSymbol is \c std::string, the key can be anything that
+    converts to \c boost::string_ref, like <c>char const *</c>.
+    With hashed_symbol_mapping and mapped_symbol_mapping, no \c std::string is
+    constructed unless the symbol is not found.
+    \throw symbol_not_found_of \<NormalSymbol> if the symbol is not in the
+        alphabet.
+    */
+    template <class Key,
+        /// \cond DONT_DOCUMENT
+        class Enable = typename std::enable_if <detail::symbol_key <
+            NormalSymbol>::template is_key <Key>::value>::type
+        /// \endcond
+    > dense_symbol_type get_dense (Key const & key) const {
+        typename detail::symbol_key <NormalSymbol>::type converted_key (key);
+        dense_type s = normal_symbol_mapping->get_dense (converted_key);
+        return dense_symbol_type (s);
+    }
+
+    /**
+    Look up a range of normal symbols.
+    This is faster than calling get_dense() for each symbol, and does not
+    throw if symbols are not in the alphabet.
+    The symbols are hashed in batches, and the memory that the lookups need is
+    prefetched while the rest of the batch is hashed.
+    \param symbols
+        A forward range of objects of type \c NormalSymbol, or of keys that
+        the overload of get_dense() for single keys accepts.
+    \param result
+        Pointer to an array with room for one dense symbol per element of
+        \a symbols.
+        For each symbol that is in the alphabet, its dense symbol is written
+        there.
+        For other symbols, the element is not changed.
+    \param missing
+        Pointer to an array with room for one \c bool per element of
+        \a symbols.
+        Each element is set to \c true if the symbol is not in the alphabet,
+        and to \c false otherwise.
+    \return The number of symbols that are not in the alphabet.
+    */
+    template <class Symbols>
+        std::size_t get_dense (Symbols const & symbols,
+            dense_symbol_type * result, bool * missing) const
+    {
+        typedef decltype (*std::begin (symbols)) reference;
+        std::size_t missing_num = 0;
+        look_up_normal_symbols (symbols,
+            [&] (std::size_t index, unsigned_dense_type dense) {
+                result [index] = dense_symbol_type (dense_type (dense));
+                missing [index] = false;
+            },
+            [&] (std::size_t index, reference,
+                typename symbol_mapping_type::hash_type)
+            {
+                missing [index] = true;
+                ++ missing_num;
+            });
+        return missing_num;
+    }
+
     /**
     \return \c true iff the dense symbol denotes a special symbol.
     The dense symbol can be a general dense symbol, or have a specific value
@@ -713,6 +1301,59 @@ public:
     }
 
 private:
+    /**
+    Look up the symbols in \a symbols in batches of detail::symbol_batch_size.
+    For each symbol, call <c>found (index, dense)</c> or
+    <c>not_found (index, symbol, hash)</c>, in order.
+    The symbols can be keys of other types than \c NormalSymbol, which are
+    converted one by one.
+    */
+    template <class Symbols, class Found, class NotFound>
+        void look_up_normal_symbols (Symbols const & symbols,
+            Found && found, NotFound && not_found) const
+    {
+        typedef detail::symbol_key <NormalSymbol> symbol_key;
+        typedef decltype (std::begin (symbols)) iterator;
+        typedef typename std::decay <decltype (*std::declval <iterator>())
+            >::type value_type;
+        static_assert (std::is_same <value_type, NormalSymbol>::value
+            || symbol_key::template is_key <value_type>::value,
+            "The range must contain normal symbols or keys to look them up.");
+        // Each batch is traversed twice: once to hash, once to look up.
+        static_assert (std::is_base_of <std::forward_iterator_tag,
+                typename std::iterator_traits <iterator>::iterator_category
+            >::value,
+            "The range must be a forward range.");
+
+        symbol_mapping_type const & mapping = *normal_symbol_mapping;
+        typename symbol_mapping_type::hash_type hashes [
+            detail::symbol_batch_size];
+        iterator first = std::begin (symbols);
+        iterator last = std::end (symbols);
+        std::size_t index = 0;
+        while (first != last) {
+            std::size_t batch_size = 0;
+            for (iterator current = first; current != last
+                && batch_size != detail::symbol_batch_size;
+                ++ current, ++ batch_size)
+            {
+                typename symbol_key::type key (*current);
+                hashes [batch_size] = mapping.hash (key);
+                mapping.prefetch (hashes [batch_size]);
+            }
+            for (std::size_t position = 0; position != batch_size;
+                ++ position, ++ first, ++ index)
+            {
+                typename symbol_key::type key (*first);
+                unsigned_dense_type dense;
+                if (mapping.find (key, hashes [position], dense))
+                    found (index, dense);
+                else
+                    not_found (index, *first, hashes [position]);
+            }
+        }
+    }
+
     /// \cond DONT_DOCUMENT
     template <class Function> struct visitor {
         Function && function;
@@ -740,7 +1381,8 @@ public:
 private:
     template <class NormalSymbol2, class Tag2,
             std::size_t max_normal_symbol_num2,
-            class SpecialSymbols2, std::size_t special_symbol_headroom2>
+            class SpecialSymbols2, std::size_t special_symbol_headroom2,
+            class SymbolMapping2>
         friend class alphabet;
 };
 
@@ -751,28 +1393,30 @@ If the alphabet already contains the symbol, then return the alphabet itself.
 template <class NewSpecialSymbol,
     class NormalSymbol, class Tag, std::size_t max_normal_symbol_num,
     class SpecialSymbols, std::size_t special_symbol_headroom,
+    class SymbolMapping,
     /// \cond DONT_DOCUMENT
     class Enable = typename std::enable_if <
         !meta::contains <NewSpecialSymbol, SpecialSymbols>::value>::type
     /// \endcond
 > inline auto
 add_special_symbol (alphabet <NormalSymbol, Tag, max_normal_symbol_num,
-    SpecialSymbols, special_symbol_headroom> const & a)
+    SpecialSymbols, special_symbol_headroom, SymbolMapping> const & a)
 RETURNS (alphabet <NormalSymbol, Tag, max_normal_symbol_num, typename
         meta::push <meta::back, NewSpecialSymbol, SpecialSymbols>::type,
-        special_symbol_headroom> (a));
+        special_symbol_headroom, SymbolMapping> (a));
 
 // If the alphabet already contains the symbol, return the alphabet itself.
 /// \cond DONT_DOCUMENT
 template <class NewSpecialSymbol,
     class NormalSymbol, class Tag, std::size_t max_normal_symbol_num,
-    class SpecialSymbols, std::size_t special_symbol_headroom
+    class SpecialSymbols, std::size_t special_symbol_headroom,
+    class SymbolMapping
     , class Enable = typename std::enable_if <
         meta::contains <NewSpecialSymbol, SpecialSymbols>::value>::type
     >
 inline auto
 add_special_symbol (alphabet <NormalSymbol, Tag, max_normal_symbol_num,
-    SpecialSymbols, special_symbol_headroom> const & a)
+    SpecialSymbols, special_symbol_headroom, SymbolMapping> const & a)
 RETURNS (a);
 /// \endcond
 
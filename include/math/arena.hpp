@@ -0,0 +1,193 @@
+/*
+Copyright 2026 Rogier van Dalen.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+
+/** \file
+Define a monotonic memory arena, and a way of making the storage of
+math::sequence come from it.
+*/
+
+#ifndef MATH_ARENA_HPP_INCLUDED
+#define MATH_ARENA_HPP_INCLUDED
+
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <algorithm>
+#include <new>
+
+namespace math {
+
+/** \brief
+Memory arena that hands out memory from large chunks, and releases it all at
+once.
+
+Deallocating memory from the arena does nothing.
+Memory is only returned when release() is called, or when the arena is
+destructed.
+This makes allocating very cheap, and it keeps the memory for objects that are
+created together close together.
+It is useful when many short-lived objects are created and then all destructed
+at the same time, as for example the sequences in a decoding pass.
+
+To make the symbols of math::sequence (and of the other sequence types, also
+when they are nested in, say, math::lexicographical) come from an arena, create
+an arena_scope for it.
+
+An arena is not thread-safe.
+Normally each thread has its own arena.
+*/
+class arena {
+    struct chunk_header {
+        chunk_header * previous;
+    };
+
+    chunk_header * chunks_;
+    char * current_;
+    char * end_;
+    std::size_t chunk_size_;
+    std::size_t allocated_;
+
+    static std::size_t constexpr header_size =
+        (sizeof (chunk_header) + alignof (std::max_align_t) - 1)
+        / alignof (std::max_align_t) * alignof (std::max_align_t);
+
+    static char * align (char * pointer, std::size_t alignment) {
+        std::uintptr_t address = reinterpret_cast <std::uintptr_t> (pointer);
+        std::uintptr_t aligned = (address + alignment - 1)
+            & ~std::uintptr_t (alignment - 1);
+        return pointer + (aligned - address);
+    }
+
+    /// Start a new chunk with space for at least \a size bytes.
+    void add_chunk (std::size_t size) {
+        std::size_t chunk_size = (std::max) (chunk_size_, size);
+        char * memory = static_cast <char *> (
+            ::operator new (header_size + chunk_size));
+        chunk_header * chunk = new (memory) chunk_header;
+        chunk->previous = chunks_;
+        chunks_ = chunk;
+        current_ = memory + header_size;
+        end_ = current_ + chunk_size;
+    }
+
+    static arena * & current_arena() {
+        static thread_local arena * current = nullptr;
+        return current;
+    }
+
+    friend class arena_scope;
+
+public:
+    /**
+    Initialise without allocating memory yet.
+    \param chunk_size
+        The size in bytes of the chunks that memory is allocated from.
+        Larger allocations get a chunk of their own.
+    */
+    explicit arena (std::size_t chunk_size = 64 * 1024)
+    : chunks_ (nullptr), current_ (nullptr), end_ (nullptr),
+        chunk_size_ (chunk_size), allocated_ (0) {}
+
+    arena (arena const &) = delete;
+    arena & operator= (arena const &) = delete;
+
+    ~arena() { release(); }
+
+    /**
+    Allocate \a size bytes, aligned to \a alignment.
+    \pre \a alignment is a power of two and at most
+    <c>alignof (std::max_align_t)</c>.
+    \throw std::bad_alloc If no memory is available.
+    */
+    void * allocate (std::size_t size, std::size_t alignment) {
+        assert (alignment != 0 && (alignment & (alignment - 1)) == 0);
+        assert (alignment <= alignof (std::max_align_t));
+        char * result = current_ ? align (current_, alignment) : nullptr;
+        if (!result || std::size_t (end_ - result) < size) {
+            add_chunk (size);
+            result = current_;
+        }
+        current_ = result + size;
+        allocated_ += size;
+        return result;
+    }
+
+    /**
+    Release all memory at once.
+    \pre No objects that use memory from the arena are still in use.
+    */
+    void release() {
+        while (chunks_) {
+            chunk_header * previous = chunks_->previous;
+            ::operator delete (chunks_);
+            chunks_ = previous;
+        }
+        current_ = nullptr;
+        end_ = nullptr;
+        allocated_ = 0;
+    }
+
+    /// \return The number of bytes allocated since the last release().
+    std::size_t allocated() const { return allocated_; }
+
+    /**
+    \return The arena that the current thread allocates from, or null if it
+    allocates from the heap.
+    */
+    static arena * current() { return current_arena(); }
+};
+
+/** \brief
+Make the current thread allocate from an arena while this object exists.
+
+While an arena_scope exists, the heap memory for the symbols of sequences that
+are created, or that grow, on this thread, comes from the arena.
+Destructing those sequences does not return the memory; it is returned only
+when the arena is released.
+Scopes can be nested; the innermost one is active.
+A scope with a null arena makes the thread allocate from the heap again.
+
+\pre Objects that use memory from the arena must not be used after the arena
+    is released.
+    This is also true for copies of those objects, and for shared_sequence
+    objects that are concatenated while the scope is active.
+    Flattening a shared_sequence, which happens when its symbols are first
+    read, always allocates from the heap.
+*/
+class arena_scope {
+    arena * previous_;
+public:
+    /**
+    Make the current thread allocate from \a a, or from the heap if \a a is
+    null.
+    */
+    explicit arena_scope (arena * a) : previous_ (arena::current_arena())
+    { arena::current_arena() = a; }
+
+    /// Make the current thread allocate from \a a.
+    explicit arena_scope (arena & a) : previous_ (arena::current_arena())
+    { arena::current_arena() = &a; }
+
+    arena_scope (arena_scope const &) = delete;
+    arena_scope & operator= (arena_scope const &) = delete;
+
+    ~arena_scope() { arena::current_arena() = previous_; }
+};
+
+} // namespace math
+
+#endif // MATH_ARENA_HPP_INCLUDED
@@ -0,0 +1,392 @@
+/*
+Copyright 2026 Rogier van Dalen.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+/** \file
+Define compact storage types for log_float values.
+
+These classes only store values.
+They do not provide arithmetic; to compute with them, convert them to
+log_float or signed_log_float, which is implicit, and convert the result back,
+which is explicit because it loses precision.
+*/
+
+#ifndef MATH_COMPACT_LOG_FLOAT_HPP_INCLUDED
+#define MATH_COMPACT_LOG_FLOAT_HPP_INCLUDED
+
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <type_traits>
+
+#include "log-float.hpp"
+
+namespace math {
+
+/** \brief
+Storage for a log_float with the exponent in fixed-point format.
+
+The exponent is stored as a signed integer \c i, which represents the value
+\f$ \exp (i / 2^{fractional\_bits}) \f$.
+This is the format that compact language model formats use for quantised
+log-probabilities.
+For example, <c>fixed_point_log_float \<std::int16_t, 10></c> takes two bytes,
+has a resolution of \f$ 2^{-10} \f$ in the exponent, which is a relative
+error of at most \f$ 2^{-11} \f$ in the value, and can store values from about
+\f$ e^{-32} \f$ to \f$ e^{32} \f$.
+
+Three integer values are reserved: the lowest for 0, the next for NaN, and
+the highest for infinity.
+
+Converting a log_float to this class rounds the exponent to the nearest
+representable value.
+If the exponent is too large, an overflow error is raised according to
+\a Policy, and infinity is stored.
+If it is too small, an underflow error is raised, and 0 is stored.
+
+\tparam Integer The signed integer type to store the exponent in.
+\tparam fractional_bits The number of bits after the binary point.
+\tparam Policy The Boost.Math policy for error handling.
+    This is also the policy of the log_float that it converts to.
+*/
+template <class Integer, int fractional_bits, class Policy = policy<>>
+    class fixed_point_log_float
+{
+    static_assert (std::numeric_limits <Integer>::is_integer
+        && std::numeric_limits <Integer>::is_signed,
+        "The exponent must be stored in a signed integer type.");
+    static_assert (0 <= fractional_bits
+        && fractional_bits < std::numeric_limits <Integer>::digits,
+        "The number of fractional bits must fit in the integer type.");
+
+    Integer value_;
+
+    static constexpr Integer zero_value = std::numeric_limits <Integer>::min();
+    static constexpr Integer nan_value = zero_value + 1;
+    static constexpr Integer infinity_value =
+        std::numeric_limits <Integer>::max();
+    static constexpr Integer lowest_value = zero_value + 2;
+    static constexpr Integer highest_value = infinity_value - 1;
+
+    template <class Exponent> static Integer encode (Exponent exponent) {
+        using std::ldexp;
+        using std::floor;
+        static char const * function_name =
+            "fixed_point_log_float constructor";
+        if ((boost::math::isnan) (exponent))
+            return nan_value;
+        if (exponent == -std::numeric_limits <Exponent>::infinity())
+            return zero_value;
+        if (exponent == std::numeric_limits <Exponent>::infinity())
+            return infinity_value;
+
+        Exponent scaled = floor (ldexp (exponent, fractional_bits) + .5);
+        // highest_value and lowest_value may not be representable in
+        // Exponent (e.g. 2^31 - 2 in float).
+        // First compare with a power of two, which is exact, so that the
+        // conversion to Integer is defined; then compare as integers.
+        Exponent const bound = ldexp (Exponent (1),
+            std::numeric_limits <Integer>::digits);
+        if (scaled >= bound
+            || (scaled >= 0 && Integer (scaled) > highest_value))
+        {
+            raise_overflow_error <Exponent> (function_name,
+                "Exponent is too large to be represented", Policy());
+            return infinity_value;
+        }
+        if (scaled < -bound
+            || (scaled < 0 && Integer (scaled) < lowest_value))
+        {
+            raise_underflow_error <Exponent> (function_name,
+                "Exponent is too small to be represented", Policy());
+            return zero_value;
+        }
+        return Integer (scaled);
+    }
+
+public:
+    /// \brief The integer type used for storage.
+    typedef Integer integer_type;
+    /// \brief The error policy.
+    typedef Policy policy_type;
+
+    /// Construct with the value 0.
+    fixed_point_log_float() : value_ (zero_value) {}
+
+    /**
+    Convert from log_float.
+    This is explicit, since the exponent is rounded.
+    */
+    template <class Exponent, class OtherPolicy>
+        explicit fixed_point_log_float (
+            log_float <Exponent, OtherPolicy> const & value)
+    : value_ (encode (value.exponent())) {}
+
+    /// \return The exponent.
+    template <class Exponent> Exponent exponent() const {
+        using std::ldexp;
+        if (value_ == zero_value)
+            return -std::numeric_limits <Exponent>::infinity();
+        if (value_ == nan_value)
+            return std::numeric_limits <Exponent>::quiet_NaN();
+        if (value_ == infinity_value)
+            return std::numeric_limits <Exponent>::infinity();
+        return ldexp (Exponent (value_), -fractional_bits);
+    }
+
+    /// Convert to log_float with the same policy.
+    template <class Exponent>
+        operator log_float <Exponent, Policy> () const
+    {
+        return log_float <Exponent, Policy> (
+            exponent <Exponent>(), as_exponent());
+    }
+
+    /// \return The stored integer.
+    Integer raw() const { return value_; }
+
+    /// \return \c true iff the two stored values are exactly equal.
+    bool operator == (fixed_point_log_float const & that) const
+    { return value_ == that.value_ && value_ != nan_value; }
+
+    /// \return \c false iff the two stored values are exactly equal.
+    bool operator != (fixed_point_log_float const & that) const
+    { return !(*this == that); }
+};
+
+/** \brief
+Storage for a log_float with the exponent in bfloat16 format.
+
+The exponent is stored as the upper 16 bits of an IEEE single-precision
+floating-point number: a sign bit, 8 exponent bits, and 7 explicit significand
+bits.
+Conversion rounds to nearest, with ties to even.
+This takes two bytes and has the same range as log_float \<float>, but the
+exponent has a relative precision of only \f$ 2^{-8} \f$.
+The precision in the value therefore depends on the magnitude of the
+exponent: for exponents between -1 and 1 the relative error in the value is at
+most about \f$ 2^{-9} \f$, but for an exponent of about -100 it is about 20%.
+This is therefore most useful for values that are not very far from 1.
+
+Infinities and NaNs are kept.
+If the exponent is too large to be represented, an overflow error is raised
+according to \a Policy, and infinity is stored.
+
+\tparam Policy The Boost.Math policy for error handling.
+    This is also the policy of the log_float that it converts to.
+*/
+template <class Policy = policy<>> class bfloat16_log_float {
+    static_assert (std::numeric_limits <float>::is_iec559,
+        "bfloat16_log_float requires IEEE floating-point numbers.");
+
+    std::uint16_t bits_;
+
+    static std::uint16_t encode (float exponent) {
+        std::uint32_t bits;
+        std::memcpy (&bits, &exponent, sizeof (bits));
+        if ((boost::math::isnan) (exponent))
+            // Keep a quiet NaN with the same sign.
+            return std::uint16_t ((bits >> 16) | 0x40);
+        // Round to nearest, ties to even.
+        std::uint32_t rounded = bits + 0x7FFF + ((bits >> 16) & 1);
+        return std::uint16_t (rounded >> 16);
+    }
+
+    template <class Exponent> static std::uint16_t encode_checked (
+        Exponent exponent)
+    {
+        static char const * function_name = "bfloat16_log_float constructor";
+        // Converting a value outside the range of float to float is
+        // undefined behaviour, so clamp first.
+        // The largest float rounds to infinity, which is reported below.
+        Exponent const largest = std::numeric_limits <float>::max();
+        std::uint16_t bits = encode (float (
+            exponent > largest ? largest
+            : exponent < -largest ? -largest : exponent));
+        // The maximum of the exponent in the last 15 bits means infinity.
+        if ((bits & 0x7FFF) == 0x7F80
+                && !(boost::math::isinf) (exponent))
+        {
+            if (exponent > 0)
+                raise_overflow_error <Exponent> (function_name,
+                    "Exponent is too large to be represented", Policy());
+            else
+                raise_underflow_error <Exponent> (function_name,
+                    "Exponent is too small to be represented", Policy());
+        }
+        return bits;
+    }
+
+public:
+    /// \brief The error policy.
+    typedef Policy policy_type;
+
+    /// Construct with the value 0.
+    bfloat16_log_float()
+    : bits_ (encode (-std::numeric_limits <float>::infinity())) {}
+
+    /**
+    Convert from log_float.
+    This is explicit, since the exponent is rounded.
+    */
+    template <class Exponent, class OtherPolicy>
+        explicit bfloat16_log_float (
+            log_float <Exponent, OtherPolicy> const & value)
+    : bits_ (encode_checked (value.exponent())) {}
+
+    /// \return The exponent.
+    float exponent() const {
+        std::uint32_t bits = std::uint32_t (bits_) << 16;
+        float result;
+        std::memcpy (&result, &bits, sizeof (result));
+        return result;
+    }
+
+    /// Convert to log_float with the same policy.
+    template <class Exponent>
+        operator log_float <Exponent, Policy> () const
+    { return log_float <Exponent, Policy> (exponent(), as_exponent()); }
+
+    /// \return The stored bits.
+    std::uint16_t raw() const { return bits_; }
+
+    /// \return \c true iff the two stored values are exactly equal.
+    bool operator == (bfloat16_log_float const & that) const
+    { return exponent() == that.exponent(); }
+
+    /// \return \c false iff the two stored values are exactly equal.
+    bool operator != (bfloat16_log_float const & that) const
+    { return !(*this == that); }
+};
+
+namespace detail {
+
+    /// Unsigned integer type with the same size as a floating-point type.
+    template <std::size_t size> struct unsigned_integer_of_size;
+    template <> struct unsigned_integer_of_size <4>
+    { typedef std::uint32_t type; };
+    template <> struct unsigned_integer_of_size <8>
+    { typedef std::uint64_t type; };
+
+} // namespace detail
+
+/** \brief
+Storage for a signed_log_float in the space of only its exponent.
+
+signed_log_float stores an \c int for the sign next to the exponent, so that
+with padding it takes twice the size of the exponent.
+This class instead stores the sign in the least significant bit of the
+significand of the exponent.
+The exponent therefore loses one bit of precision: when converting from
+signed_log_float, it is rounded towards zero to a value with an even
+significand.
+This is an error of at most one unit in the last place of the exponent \c e,
+so the relative error in the value is at most about \f$ |e| 2^{-52} \f$ for
+\c double.
+
+Infinities and NaNs are kept: setting the last bit of an infinity turns it into
+a NaN, but decoding clears the bit again.
+Extracting the sign and the exponent is therefore a mask operation, without any
+branches.
+
+\tparam Exponent The type of the exponent, which must be an IEEE \c float or
+    \c double.
+\tparam Policy The Boost.Math policy for error handling.
+    This is also the policy of the signed_log_float that it converts to.
+*/
+template <class Exponent = double, class Policy = policy<>>
+    class packed_signed_log_float
+{
+    static_assert (std::numeric_limits <Exponent>::is_iec559,
+        "packed_signed_log_float requires IEEE floating-point numbers.");
+
+    typedef typename detail::unsigned_integer_of_size <sizeof (Exponent)>::type
+        bits_type;
+
+    bits_type bits_;
+
+    static bits_type encode (Exponent exponent, int sign) {
+        bits_type bits;
+        std::memcpy (&bits, &exponent, sizeof (bits));
+        return (bits & ~bits_type (1)) | bits_type (sign < 0);
+    }
+
+public:
+    /// \brief The type of the underlying exponent.
+    typedef Exponent exponent_type;
+    /// \brief The error policy.
+    typedef Policy policy_type;
+
+    /// Construct with the value 0.
+    packed_signed_log_float()
+    : bits_ (encode (-std::numeric_limits <Exponent>::infinity(), +1)) {}
+
+    /**
+    Convert from signed_log_float.
+    This is explicit, since the exponent is rounded.
+    */
+    template <class OtherExponent, class OtherPolicy>
+        explicit packed_signed_log_float (
+            signed_log_float <OtherExponent, OtherPolicy> const & value)
+    : bits_ (encode (value.exponent(), value.sign())) {}
+
+    /**
+    Convert from log_float.
+    This is explicit, since the exponent is rounded.
+    */
+    template <class OtherExponent, class OtherPolicy>
+        explicit packed_signed_log_float (
+            log_float <OtherExponent, OtherPolicy> const & value)
+    : bits_ (encode (value.exponent(), +1)) {}
+
+    /// \return The exponent.
+    Exponent exponent() const {
+        bits_type bits = bits_ & ~bits_type (1);
+        Exponent result;
+        std::memcpy (&result, &bits, sizeof (result));
+        return result;
+    }
+
+    /// \return The sign (either -1 or +1).
+    int sign() const { return 1 - 2 * int (bits_ & 1); }
+
+    /// Convert to signed_log_float with the same policy.
+    template <class OtherExponent>
+        operator signed_log_float <OtherExponent, Policy> () const
+    {
+        return signed_log_float <OtherExponent, Policy> (
+            exponent(), sign(), as_exponent());
+    }
+
+    /**
+    \return \c true iff the two stored values are equal.
+    As for signed_log_float, zeros compare equal whatever their sign, and NaN
+    is not equal to anything.
+    */
+    bool operator == (packed_signed_log_float const & that) const {
+        return exponent() == that.exponent() && (sign() == that.sign()
+            || exponent() == -std::numeric_limits <Exponent>::infinity());
+    }
+
+    /// \return \c false iff the two stored values are equal.
+    bool operator != (packed_signed_log_float const & that) const
+    { return !(*this == that); }
+};
+
+} // namespace math
+
+#endif // MATH_COMPACT_LOG_FLOAT_HPP_INCLUDED
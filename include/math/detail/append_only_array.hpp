@@ -0,0 +1,150 @@
+/*
+Copyright 2026 Rogier van Dalen.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+
+/** \file
+Define an array that one thread can append to while other threads read it.
+*/
+
+#ifndef MATH_DETAIL_APPEND_ONLY_ARRAY_HPP_INCLUDED
+#define MATH_DETAIL_APPEND_ONLY_ARRAY_HPP_INCLUDED
+
+#include <cassert>
+#include <cstddef>
+#include <atomic>
+#include <limits>
+#include <new>
+#include <utility>
+
+namespace math { namespace detail {
+
+/**
+\return The index of the highest bit that is set in \a value.
+\pre <c>value != 0</c>.
+*/
+inline unsigned highest_set_bit (unsigned long long value) {
+    assert (value != 0);
+#if defined (__GNUC__)
+    return unsigned (std::numeric_limits <unsigned long long>::digits - 1
+        - __builtin_clzll (value));
+#else
+    unsigned index = 0;
+    for (value >>= 1; value != 0; value >>= 1)
+        ++ index;
+    return index;
+#endif
+}
+
+/**
+Array that elements can be appended to, but not removed from, and that can be
+read while elements are appended.
+
+The elements are kept in segments, each twice as large as the previous one.
+Segments are never moved, so references to elements remain valid until the
+array is destructed.
+Within each segment, the elements are contiguous.
+
+Only one thread at a time may call push_back().
+Any number of threads may call size() and operator[] at the same time, also
+while an element is being appended.
+An element is visible to other threads only once it has been constructed
+completely.
+*/
+template <class Element> class append_only_array {
+    // The first segment has room for 2^first_segment_bits elements.
+    static unsigned constexpr first_segment_bits = 4;
+    static std::size_t constexpr first_segment_size =
+        std::size_t (1) << first_segment_bits;
+    static unsigned constexpr segment_num =
+        std::numeric_limits <std::size_t>::digits - first_segment_bits;
+
+    std::atomic <Element *> segments_ [segment_num];
+    std::atomic <std::size_t> size_;
+
+    /**
+    Segment \c k contains the elements from index
+    <c>first_segment_size * (2^k - 1)</c>.
+    */
+    static unsigned segment_of (std::size_t index)
+    { return highest_set_bit (index / first_segment_size + 1); }
+
+    static std::size_t segment_size (unsigned segment)
+    { return first_segment_size << segment; }
+
+    static std::size_t segment_offset (std::size_t index, unsigned segment)
+    { return index + first_segment_size - segment_size (segment); }
+
+public:
+    append_only_array() : size_ (0) {
+        for (std::atomic <Element *> & segment : segments_)
+            segment.store (nullptr, std::memory_order_relaxed);
+    }
+
+    append_only_array (append_only_array const &) = delete;
+    append_only_array & operator = (append_only_array const &) = delete;
+
+    ~append_only_array() {
+        std::size_t size = size_.load (std::memory_order_relaxed);
+        for (std::size_t index = 0; index != size; ++ index)
+            (*this) [index].~Element();
+        for (std::atomic <Element *> & segment : segments_)
+            ::operator delete (segment.load (std::memory_order_relaxed));
+    }
+
+    /**
+    \return The number of elements.
+    All elements with a lower index can be read.
+    */
+    std::size_t size() const { return size_.load (std::memory_order_acquire); }
+
+    /**
+    \return The element at \a index.
+    \pre <c>index < size()</c>.
+    */
+    Element const & operator [] (std::size_t index) const {
+        unsigned segment = segment_of (index);
+        return segments_ [segment].load (std::memory_order_relaxed) [
+            segment_offset (index, segment)];
+    }
+
+    /**
+    Append an element.
+    If this throws an exception, the array is unchanged.
+    \pre No other thread calls this at the same time.
+    */
+    template <class ... Arguments> void emplace_back (Arguments && ... arguments)
+    {
+        std::size_t index = size_.load (std::memory_order_relaxed);
+        unsigned segment = segment_of (index);
+        Element * memory = segments_ [segment].load (std::memory_order_relaxed);
+        if (!memory) {
+            memory = static_cast <Element *> (::operator new (
+                segment_size (segment) * sizeof (Element)));
+            segments_ [segment].store (memory, std::memory_order_relaxed);
+        }
+        new (memory + segment_offset (index, segment))
+            Element (std::forward <Arguments> (arguments) ...);
+        // Publish the element, and the segment pointer, to readers.
+        size_.store (index + 1, std::memory_order_release);
+    }
+
+    /// Append a copy of an element.
+    void push_back (Element const & element) { emplace_back (element); }
+};
+
+}} // namespace math::detail
+
+#endif // MATH_DETAIL_APPEND_ONLY_ARRAY_HPP_INCLUDED
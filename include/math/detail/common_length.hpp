@@ -0,0 +1,131 @@
+/*
+Copyright 2026 Rogier van Dalen.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+
+/** \file
+Find the length of the common prefix or suffix of two arrays of symbols.
+*/
+
+#ifndef MATH_DETAIL_COMMON_LENGTH_HPP_INCLUDED
+#define MATH_DETAIL_COMMON_LENGTH_HPP_INCLUDED
+
+#include <cstddef>
+#include <cstring>
+#include <type_traits>
+
+namespace math { namespace detail {
+
+/**
+Evaluate to \c true iff two objects of type \a Symbol compare equal exactly
+when their object representations are equal.
+This is true for integers, but not for floating-point numbers or for types with
+padding.
+Specialise this for symbol types that wrap an integer.
+*/
+template <class Symbol, class Enable = void> struct is_bitwise_comparable
+: std::integral_constant <bool,
+    std::is_integral <Symbol>::value || std::is_enum <Symbol>::value> {};
+
+/**
+The number of bytes that common_prefix_length and common_suffix_length
+compare at once.
+*/
+static std::size_t constexpr common_length_block_bytes = 64;
+
+template <class Symbol> inline std::size_t common_prefix_length (
+    Symbol const * first1, Symbol const * first2, std::size_t size,
+    std::false_type)
+{
+    std::size_t length = 0;
+    while (length != size && first1 [length] == first2 [length])
+        ++ length;
+    return length;
+}
+
+/*
+Compare blocks with memcmp, which is vectorised, and then find the first
+difference in the block that differs.
+*/
+template <class Symbol> inline std::size_t common_prefix_length (
+    Symbol const * first1, Symbol const * first2, std::size_t size,
+    std::true_type)
+{
+    // Slices of the same storage often start at the same place.
+    if (first1 == first2)
+        return size;
+    std::size_t constexpr block = sizeof (Symbol) < common_length_block_bytes
+        ? common_length_block_bytes / sizeof (Symbol) : 1;
+    std::size_t length = 0;
+    while (size - length >= block && std::memcmp (first1 + length,
+            first2 + length, block * sizeof (Symbol)) == 0)
+        length += block;
+    while (length != size && first1 [length] == first2 [length])
+        ++ length;
+    return length;
+}
+
+template <class Symbol> inline std::size_t common_suffix_length (
+    Symbol const * last1, Symbol const * last2, std::size_t size,
+    std::false_type)
+{
+    std::size_t length = 0;
+    while (length != size && *(last1 - length - 1) == *(last2 - length - 1))
+        ++ length;
+    return length;
+}
+
+template <class Symbol> inline std::size_t common_suffix_length (
+    Symbol const * last1, Symbol const * last2, std::size_t size,
+    std::true_type)
+{
+    if (last1 == last2)
+        return size;
+    std::size_t constexpr block = sizeof (Symbol) < common_length_block_bytes
+        ? common_length_block_bytes / sizeof (Symbol) : 1;
+    std::size_t length = 0;
+    while (size - length >= block && std::memcmp (last1 - length - block,
+            last2 - length - block, block * sizeof (Symbol)) == 0)
+        length += block;
+    while (length != size && *(last1 - length - 1) == *(last2 - length - 1))
+        ++ length;
+    return length;
+}
+
+/**
+\return The number of symbols that the arrays starting at \a first1 and
+\a first2 have in common at the start, up to \a size.
+*/
+template <class Symbol> inline std::size_t common_prefix_length (
+    Symbol const * first1, Symbol const * first2, std::size_t size)
+{
+    return common_prefix_length (first1, first2, size,
+        std::integral_constant <bool, is_bitwise_comparable <Symbol>::value>());
+}
+
+/**
+\return The number of symbols that the arrays ending at \a last1 and \a last2
+have in common at the end, up to \a size.
+*/
+template <class Symbol> inline std::size_t common_suffix_length (
+    Symbol const * last1, Symbol const * last2, std::size_t size)
+{
+    return common_suffix_length (last1, last2, size,
+        std::integral_constant <bool, is_bitwise_comparable <Symbol>::value>());
+}
+
+}} // namespace math::detail
+
+#endif // MATH_DETAIL_COMMON_LENGTH_HPP_INCLUDED
@@ -24,7 +24,9 @@ These also take Boost.Math policies with regard to error handling into account.
 
 #include <cmath>
 #include <cassert>
+#include <cstddef>
 #include <limits>
+#include <type_traits>
 
 #include <boost/static_assert.hpp>
 #include <boost/math/policies/policy.hpp>
@@ -44,6 +46,93 @@ namespace math { namespace detail {
     using std::exp;
     using std::log;
 
+    /**
+    Table of log1p (exp (-d)) for d from 0 to \c cutoff, at intervals of
+    1 / points_per_unit.
+    Linear interpolation in this table has an absolute error of at most
+    \f$ h^2/8 \cdot \max |f''| = 2^{-12} / 32 < 7.7 \cdot 10^{-6} \f$, where
+    \f$ h = 1/64 \f$ and \f$ f'' \le 1/4 \f$.
+    Beyond the cutoff, log1p (exp (-d)) < 6.2e-6, so 0 is returned.
+    The result of addition therefore has a relative error of less than
+    \f$ 2^{-16} \f$.
+    */
+    template <class RealType> class log1p_exp_table {
+    public:
+        static int constexpr points_per_unit = 64;
+        static int constexpr cutoff = 12;
+        static std::size_t constexpr size = cutoff * points_per_unit + 2;
+        /// The number of bits of precision the table provides.
+        static int constexpr precision = 16;
+
+    private:
+        RealType values_ [size];
+
+        log1p_exp_table() {
+            for (std::size_t i = 0; i != size; ++ i)
+                values_ [i] = log1p (exp (-RealType (i) / points_per_unit));
+        }
+
+    public:
+        /**
+        \return An approximation of log1p (exp (difference)).
+        \pre !(difference > 0)
+        */
+        RealType operator() (RealType const & difference) const {
+            RealType position = -difference * points_per_unit;
+            if (position < cutoff * points_per_unit) {
+                std::size_t index = std::size_t (position);
+                RealType fraction = position - RealType (index);
+                return values_ [index]
+                    + fraction * (values_ [index + 1] - values_ [index]);
+            } else if (position >= cutoff * points_per_unit) {
+                // The smaller operand is negligible.
+                return 0;
+            } else {
+                // NaN.
+                return difference;
+            }
+        }
+
+        static log1p_exp_table const & get() {
+            // Initialisation of function-local statics is thread-safe.
+            static log1p_exp_table const table;
+            return table;
+        }
+    };
+
+    /**
+    Evaluate to \c true iff the policy is a table_addition_policy, so that
+    log1p_exp_table is used instead of log1p and exp.
+    */
+    template <class Policy> struct use_log1p_exp_table
+    : std::false_type {};
+
+    template <class Policy>
+        struct use_log1p_exp_table <table_addition_policy <Policy>>
+    : std::true_type {};
+
+    template <class RealType>
+        inline RealType log1p_exp (RealType const & difference,
+            std::false_type)
+    { return log1p (exp (difference)); }
+
+    template <class RealType>
+        inline RealType log1p_exp (RealType const & difference,
+            std::true_type)
+    { return log1p_exp_table <RealType>::get() (difference); }
+
+    /**
+    Compute log1p (exp (difference)), approximately if \a Policy is a
+    table_addition_policy, and exactly otherwise.
+    \pre !(difference > 0)
+    */
+    template <class RealType, class Policy>
+        inline RealType log1p_exp (RealType const & difference, Policy const &)
+    {
+        return log1p_exp (difference,
+            typename use_log1p_exp_table <Policy>::type());
+    }
+
     /**
     Multiply two numbers represented as their logs.
     This is equivalent to adding them.
@@ -316,9 +405,9 @@ namespace math { namespace detail {
         } else {
             result_type result;
             if (loga > logb)
-                result = loga + log1p (exp (logb - loga));
+                result = loga + log1p_exp <result_type> (logb - loga, policy);
             else
-                result = logb + log1p (exp (loga - logb));
+                result = logb + log1p_exp <result_type> (loga - logb, policy);
 
             if (result == result_infinity &&
                     loga != a_infinity && logb != b_infinity) {
@@ -382,7 +471,7 @@ namespace math { namespace detail {
         if (!::boost::math::isinf (loga)) {
             result_type difference = -abs (logb - loga);
             result_type greatest = (max) (loga, logb);
-            return greatest + log1p (exp (difference));
+            return greatest + log1p_exp (difference, policy);
         } else {
             if (!(loga >= logb))
                 return result_type (logb);
@@ -41,6 +41,17 @@ namespace math {
     */
     class as_exponent {};
 
+    /**
+    Boost.Math policy that behaves like \a Policy, but also makes addition of
+    log_float and signed_log_float use a precomputed table instead of \c log1p
+    and \c exp.
+    The relative error of the result of addition is then less than
+    \f$ 2^{-16} \f$ (about \f$ 1.5 \cdot 10^{-5} \f$).
+    For example, <c>log_float \<float, table_addition_policy<>></c>.
+    */
+    template <class Policy = policy<>> struct table_addition_policy
+    : Policy {};
+
     template <class ExponentType = double, class Policy = policy<> >
         class log_float;
     template <class ExponentType = double, class Policy = policy<> >
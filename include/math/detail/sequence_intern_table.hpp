@@ -0,0 +1,209 @@
+/*
+Copyright 2026 Rogier van Dalen.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+
+/** \file
+Define the table that math::interned_sequence uses to keep one copy of each
+distinct sequence of symbols.
+*/
+
+#ifndef MATH_DETAIL_SEQUENCE_INTERN_TABLE_HPP_INCLUDED
+#define MATH_DETAIL_SEQUENCE_INTERN_TABLE_HPP_INCLUDED
+
+#include <cassert>
+#include <cstddef>
+#include <algorithm>
+#include <atomic>
+#include <mutex>
+#include <unordered_map>
+
+#include "sequence_storage.hpp"
+
+namespace math { namespace detail {
+
+/**
+Table with one entry for each distinct sequence of symbols that is in use.
+
+Looking up a sequence of symbols with acquire() returns the entry for those
+symbols, creating it if there is none yet.
+Two lookups for equal symbols therefore return the same entry, so that
+sequences can be compared by comparing pointers to their entries.
+
+Entries are reference-counted.
+When the last reference is released, the entry is removed from the table.
+
+The table is split into a number of shards, each with its own mutex, chosen by
+the hash value of the symbols, so that threads that look up different sequences
+rarely wait for each other.
+Copying a reference and releasing one that is not the last does not lock.
+
+The hash function is supplied by the caller, so that the hash values can be the
+same as those of other sequence types.
+*/
+template <class Symbol> class sequence_intern_table {
+public:
+    typedef sequence_storage <Symbol> storage_type;
+
+    /** \brief
+    Entry in the table.
+    The symbols and the hash value never change.
+    */
+    class entry {
+        friend class sequence_intern_table;
+
+        storage_type symbols_;
+        std::size_t hash_;
+        std::atomic <std::size_t> reference_count_;
+
+        entry (Symbol const * first, Symbol const * last, std::size_t hash)
+        : symbols_ (first, last), hash_ (hash), reference_count_ (1) {}
+
+    public:
+        storage_type const & symbols() const { return symbols_; }
+        std::size_t hash() const { return hash_; }
+    };
+
+private:
+    static std::size_t constexpr shard_count = 64;
+
+    struct shard {
+        std::mutex mutex;
+        std::unordered_multimap <std::size_t, entry *> entries;
+    };
+
+    shard shards_ [shard_count];
+
+    shard & shard_for (std::size_t hash) {
+        // The low bits of some hash functions are not very random.
+        return shards_ [(hash ^ (hash >> 17) ^ (hash >> 31)) % shard_count];
+    }
+
+    sequence_intern_table() {}
+
+public:
+    sequence_intern_table (sequence_intern_table const &) = delete;
+    sequence_intern_table & operator= (sequence_intern_table const &) = delete;
+
+    /**
+    \return The table for \a Symbol.
+    This is never destructed, so that sequences that are destructed after the
+    end of \c main can still release their entries.
+    */
+    static sequence_intern_table & instance() {
+        static sequence_intern_table * const table = new sequence_intern_table;
+        return *table;
+    }
+
+    /**
+    \return The entry for the symbols in [first, last), with its reference
+    count incremented.
+    If there is no such entry, it is created, with a copy of the symbols.
+    \param hash The hash value of the symbols.
+        This must be the same for all calls with the same symbols.
+    */
+    entry * acquire (Symbol const * first, Symbol const * last,
+        std::size_t hash)
+    {
+        shard & s = shard_for (hash);
+        std::lock_guard <std::mutex> lock (s.mutex);
+        auto candidates = s.entries.equal_range (hash);
+        for (auto current = candidates.first; current != candidates.second;
+            ++ current)
+        {
+            entry * candidate = current->second;
+            storage_type const & symbols = candidate->symbols_;
+            if (std::size_t (last - first) == symbols.size()
+                    && std::equal (first, last, symbols.begin()))
+            {
+                candidate->reference_count_.fetch_add (
+                    1, std::memory_order_relaxed);
+                return candidate;
+            }
+        }
+        // The entry may outlive any arena, so it is allocated on the heap.
+        arena_scope heap (nullptr);
+        entry * result = new entry (first, last, hash);
+        try {
+            s.entries.insert (std::make_pair (hash, result));
+        } catch (...) {
+            delete result;
+            throw;
+        }
+        return result;
+    }
+
+    /**
+    Increment the reference count of an entry.
+    \pre The caller holds a reference to the entry.
+    */
+    static void add_reference (entry * e) {
+        e->reference_count_.fetch_add (1, std::memory_order_relaxed);
+    }
+
+    /**
+    Decrement the reference count of an entry, and remove it from the table if
+    this was the last reference.
+    */
+    void release (entry * e) {
+        // If this is not the last reference, no lock is needed.
+        std::size_t count = e->reference_count_.load (
+            std::memory_order_relaxed);
+        while (count > 1) {
+            if (e->reference_count_.compare_exchange_weak (
+                    count, count - 1, std::memory_order_acq_rel))
+                return;
+        }
+        // This may be the last reference.
+        // Under the lock, acquire() cannot hand out a new reference.
+        shard & s = shard_for (e->hash_);
+        {
+            std::lock_guard <std::mutex> lock (s.mutex);
+            if (e->reference_count_.fetch_sub (1, std::memory_order_acq_rel)
+                    != 1)
+                return;
+            auto candidates = s.entries.equal_range (e->hash_);
+            for (auto current = candidates.first;
+                current != candidates.second; ++ current)
+            {
+                if (current->second == e) {
+                    s.entries.erase (current);
+                    break;
+                }
+            }
+        }
+        delete e;
+    }
+
+    /**
+    \return The number of entries in the table.
+    This is mainly useful for testing.
+    */
+    std::size_t size() {
+        std::size_t result = 0;
+        for (shard & s : shards_) {
+            std::lock_guard <std::mutex> lock (s.mutex);
+            result += s.entries.size();
+        }
+        return result;
+    }
+};
+
+template <class Symbol>
+    std::size_t constexpr sequence_intern_table <Symbol>::shard_count;
+
+}} // namespace math::detail
+
+#endif // MATH_DETAIL_SEQUENCE_INTERN_TABLE_HPP_INCLUDED
@@ -0,0 +1,404 @@
+/*
+Copyright 2026 Rogier van Dalen.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+
+/** \file
+Define the storage for the symbols in math::sequence.
+*/
+
+#ifndef MATH_DETAIL_SEQUENCE_STORAGE_HPP_INCLUDED
+#define MATH_DETAIL_SEQUENCE_STORAGE_HPP_INCLUDED
+
+#include <cassert>
+#include <cstddef>
+#include <algorithm>
+#include <atomic>
+#include <iterator>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+#include "../arena.hpp"
+
+namespace math { namespace detail {
+
+/**
+The number of symbols that sequence_storage keeps inside the object itself,
+without allocating memory.
+By default, this is as many symbols as fit in 32 bytes, and at least one.
+This can be specialised for specific symbol types.
+*/
+template <class Symbol> struct sequence_inline_capacity
+: std::integral_constant <std::size_t,
+    (sizeof (Symbol) < 32 ? 32 / sizeof (Symbol) : 1)> {};
+
+/**
+Storage for the symbols of a sequence.
+
+Up to \c inline_capacity symbols are stored inside the object itself, so that
+short sequences do not allocate any memory.
+Longer sequences are stored in a block on the heap.
+Since sequences are immutable, copies of the storage share the same heap block,
+which is reference-counted.
+A slice of the symbols, as returned by slice(), shares the heap block too, with
+an offset and a length, unless it is short enough to be stored inline.
+
+Symbols can be added at the end with push_back() and append().
+If the heap block is shared, or the storage is a slice that does not extend to
+the end of the block, the symbols are first copied into a new block.
+
+The hash value of the symbols in a heap block is computed only once, and kept
+in the block; see hash().
+
+If an arena_scope is active on the current thread when a heap block is
+allocated, the block comes from its arena.
+The symbols in it are still destructed when the last reference to the block
+goes away, but the memory is only returned when the arena is released.
+*/
+template <class Symbol> class sequence_storage {
+public:
+    static std::size_t constexpr inline_capacity =
+        sequence_inline_capacity <Symbol>::value;
+
+private:
+    /**
+    Header of a heap block.
+    It is followed in memory by space for \c capacity symbols, of which the
+    first \c size have been constructed.
+    */
+    struct block_header {
+        std::atomic <std::size_t> reference_count;
+        std::size_t capacity;
+        std::size_t size;
+        // Whether the memory comes from an arena, and must not be deleted.
+        bool in_arena;
+        // The hash value of all symbols in the block, if has_hash is set.
+        std::atomic <bool> has_hash;
+        std::atomic <std::size_t> hash;
+
+        block_header (std::size_t capacity, bool in_arena)
+        : reference_count (1), capacity (capacity), size (0),
+            in_arena (in_arena), has_hash (false), hash (0) {}
+    };
+
+    static std::size_t constexpr symbols_offset =
+        (sizeof (block_header) + alignof (Symbol) - 1)
+        / alignof (Symbol) * alignof (Symbol);
+
+    static Symbol * block_symbols (block_header * block) {
+        return reinterpret_cast <Symbol *> (
+            reinterpret_cast <char *> (block) + symbols_offset);
+    }
+
+    static std::size_t constexpr block_alignment =
+        alignof (block_header) < alignof (Symbol)
+        ? alignof (Symbol) : alignof (block_header);
+
+    static block_header * allocate_block (std::size_t capacity) {
+        std::size_t size = symbols_offset + capacity * sizeof (Symbol);
+        arena * current_arena = arena::current();
+        if (current_arena && block_alignment <= alignof (std::max_align_t))
+        {
+            void * memory = current_arena->allocate (size, block_alignment);
+            return new (memory) block_header (capacity, true);
+        }
+        void * memory = ::operator new (size);
+        return new (memory) block_header (capacity, false);
+    }
+
+    static void release_block (block_header * block) {
+        if (block->reference_count.fetch_sub (1, std::memory_order_acq_rel)
+            == 1)
+        {
+            destroy (block_symbols (block), block->size);
+            bool in_arena = block->in_arena;
+            block->~block_header();
+            if (!in_arena)
+                ::operator delete (block);
+        }
+    }
+
+    static void destroy (Symbol * symbols, std::size_t size) {
+        for (std::size_t i = 0; i != size; ++ i)
+            symbols [i].~Symbol();
+    }
+
+    /// Null iff the symbols are stored inline.
+    block_header * block_;
+    /// The position of the first symbol in the heap block.
+    std::size_t offset_;
+    std::size_t size_;
+    typename std::aligned_storage <sizeof (Symbol) * inline_capacity,
+        alignof (Symbol)>::type inline_symbols_;
+
+    Symbol * inline_symbols()
+    { return reinterpret_cast <Symbol *> (&inline_symbols_); }
+    Symbol const * inline_symbols() const
+    { return reinterpret_cast <Symbol const *> (&inline_symbols_); }
+
+    Symbol * mutable_begin() {
+        return block_ ? block_symbols (block_) + offset_
+            : inline_symbols();
+    }
+
+    bool is_unique() const {
+        return !block_
+            || block_->reference_count.load (std::memory_order_acquire) == 1;
+    }
+
+    /**
+    \return \c true iff this is the only owner of the heap block and the
+    symbols extend to the end of it, so that symbols can be added in place.
+    \pre The symbols are on the heap.
+    */
+    bool owns_block() const {
+        return is_unique() && offset_ + size_ == block_->size;
+    }
+
+    /// \pre There is space for one more symbol.
+    template <class Argument> void construct_back (Argument && argument) {
+        new (mutable_begin() + size_) Symbol (
+            std::forward <Argument> (argument));
+        if (block_) {
+            ++ block_->size;
+            block_->has_hash.store (false, std::memory_order_relaxed);
+        }
+        ++ size_;
+    }
+
+    /**
+    Move or copy the symbols into new storage with space for \a capacity
+    symbols.
+    */
+    void reallocate (std::size_t capacity) {
+        assert (capacity >= size_);
+        sequence_storage fresh (capacity);
+        Symbol * source = mutable_begin();
+        if (!block_ || owns_block()) {
+            for (std::size_t i = 0; i != size_; ++ i)
+                fresh.construct_back (std::move_if_noexcept (source [i]));
+        } else {
+            for (std::size_t i = 0; i != size_; ++ i)
+                fresh.construct_back (
+                    static_cast <Symbol const &> (source [i]));
+        }
+        clear();
+        take_from (fresh);
+    }
+
+    /// \pre This is empty.
+    void take_from (sequence_storage & that) {
+        assert (!block_ && size_ == 0);
+        if (that.block_) {
+            block_ = that.block_;
+            offset_ = that.offset_;
+            size_ = that.size_;
+            that.block_ = nullptr;
+            that.offset_ = 0;
+            that.size_ = 0;
+        } else {
+            for (; size_ != that.size_; ++ size_)
+                new (inline_symbols() + size_) Symbol (
+                    std::move (that.inline_symbols() [size_]));
+            that.clear();
+        }
+    }
+
+    void copy_from (sequence_storage const & that) {
+        assert (!block_ && size_ == 0);
+        if (that.block_) {
+            that.block_->reference_count.fetch_add (
+                1, std::memory_order_relaxed);
+            block_ = that.block_;
+            offset_ = that.offset_;
+            size_ = that.size_;
+        } else {
+            try {
+                for (; size_ != that.size_; ++ size_)
+                    new (inline_symbols() + size_) Symbol (
+                        that.inline_symbols() [size_]);
+            } catch (...) {
+                clear();
+                throw;
+            }
+        }
+    }
+
+    void clear() {
+        if (block_)
+            release_block (block_);
+        else
+            destroy (inline_symbols(), size_);
+        block_ = nullptr;
+        offset_ = 0;
+        size_ = 0;
+    }
+
+public:
+    /// Initialise empty.
+    sequence_storage() : block_ (nullptr), offset_ (0), size_ (0) {}
+
+    /**
+    Initialise empty, with space for \a capacity symbols, so that adding that
+    many symbols does not allocate memory again.
+    */
+    explicit sequence_storage (std::size_t capacity)
+    : block_ (nullptr), offset_ (0), size_ (0)
+    {
+        if (capacity > inline_capacity)
+            block_ = allocate_block (capacity);
+    }
+
+    /// Initialise with copies of the symbols in [first, last).
+    template <class Iterator> sequence_storage (Iterator first, Iterator last)
+    : block_ (nullptr), offset_ (0), size_ (0)
+    { append (first, last); }
+
+    sequence_storage (sequence_storage const & that)
+    : block_ (nullptr), offset_ (0), size_ (0)
+    { copy_from (that); }
+
+    /**
+    Move.
+    Heap blocks are handed over; inline symbols are moved one by one, so this
+    is noexcept if moving a Symbol is.
+    */
+    sequence_storage (sequence_storage && that)
+        noexcept (std::is_nothrow_move_constructible <Symbol>::value)
+    : block_ (nullptr), offset_ (0), size_ (0)
+    { take_from (that); }
+
+    ~sequence_storage() { clear(); }
+
+    sequence_storage & operator= (sequence_storage const & that) {
+        if (this != &that) {
+            sequence_storage copy (that);
+            clear();
+            take_from (copy);
+        }
+        return *this;
+    }
+
+    sequence_storage & operator= (sequence_storage && that)
+        noexcept (std::is_nothrow_move_constructible <Symbol>::value)
+    {
+        if (this != &that) {
+            clear();
+            take_from (that);
+        }
+        return *this;
+    }
+
+    std::size_t size() const { return size_; }
+    bool empty() const { return size_ == 0; }
+
+    /**
+    \return The number of symbols that this can contain before push_back()
+    needs to allocate memory.
+    */
+    std::size_t capacity() const {
+        if (!block_)
+            return inline_capacity;
+        if (owns_block())
+            return block_->capacity - offset_;
+        return size_;
+    }
+
+    /// \return \c true iff the symbols are stored in the object itself.
+    bool is_inline() const { return !block_; }
+
+    Symbol const * begin() const {
+        return block_ ? block_symbols (block_) + offset_
+            : inline_symbols();
+    }
+    Symbol const * end() const { return begin() + size_; }
+
+    /**
+    \return Storage with the \a size symbols starting at position \a first.
+    If the symbols are stored on the heap, and the slice does not fit inline,
+    the result shares the heap block, so that this takes constant time and does
+    not allocate memory.
+    \pre <c>first + size \<= this->size()</c>.
+    */
+    sequence_storage slice (std::size_t first, std::size_t size) const {
+        assert (first + size <= size_);
+        if (!block_ || size <= inline_capacity)
+            return sequence_storage (begin() + first, begin() + first + size);
+        sequence_storage result (*this);
+        result.offset_ += first;
+        result.size_ = size;
+        return result;
+    }
+
+    /**
+    \return <c>hash (begin(), end())</c>.
+    If the symbols are all the symbols in a heap block, the result is kept in
+    the block, so that it is computed only once for all storage objects that
+    share the block.
+    This is thread-safe.
+    \param hash
+        Function that returns the hash value of the symbols between two
+        pointers.
+        The caller must always use the same function for the same \a Symbol.
+    */
+    template <class Hash> std::size_t hash (Hash const & hash) const {
+        if (!block_ || offset_ != 0 || size_ != block_->size)
+            return hash (begin(), end());
+        if (block_->has_hash.load (std::memory_order_acquire))
+            return block_->hash.load (std::memory_order_relaxed);
+        // Other threads may compute the same value at the same time.
+        std::size_t result = hash (begin(), end());
+        block_->hash.store (result, std::memory_order_relaxed);
+        block_->has_hash.store (true, std::memory_order_release);
+        return result;
+    }
+
+    /**
+    Make sure that \a capacity symbols fit without allocating memory.
+    */
+    void reserve (std::size_t capacity) {
+        if (capacity > this->capacity())
+            reallocate (capacity);
+    }
+
+    /**
+    Add a symbol at the end.
+    */
+    void push_back (Symbol const & symbol) {
+        if (size_ == capacity())
+            reallocate ((std::max) (2 * size_, inline_capacity + 1));
+        construct_back (symbol);
+    }
+
+    /**
+    Add copies of the symbols in [first, last) at the end.
+    */
+    template <class Iterator> void append (Iterator first, Iterator last) {
+        typedef typename std::iterator_traits <Iterator>::iterator_category
+            category;
+        if (std::is_base_of <std::forward_iterator_tag, category>::value)
+            reserve (size_ + std::size_t (std::distance (first, last)));
+        for (; first != last; ++ first)
+            push_back (*first);
+    }
+};
+
+template <class Symbol>
+    std::size_t constexpr sequence_storage <Symbol>::inline_capacity;
+
+}} // namespace math::detail
+
+#endif // MATH_DETAIL_SEQUENCE_STORAGE_HPP_INCLUDED
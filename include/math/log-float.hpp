@@ -28,8 +28,10 @@ Define the log_float and signed_log_float classes.
 #include <limits>
 // For std::min
 #include <algorithm>
-// For std::pair and std::tie
+// For std::pair
 #include <utility>
+// For std::tie
+#include <tuple>
 #include <type_traits>
 
 #include <boost/utility/enable_if.hpp>
@@ -71,6 +73,8 @@ namespace math {
     The policy is used for error handling in operations.
     Objects of this class that use different policies are not implicitly
     compatible and need to be converted explicitly first.
+    If the policy is a table_addition_policy, then addition uses a
+    precomputed table instead of \c log1p and \c exp.
 
     Some free functions that are available for floating-point numbers are
     provided: exp(),  log(), pow(),  sqrt().
@@ -0,0 +1,373 @@
+/*
+Copyright 2026 Rogier van Dalen.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+/** \file
+Operations on contiguous arrays of log_float.
+
+The scalar operations in log-float.hpp deal with corner cases (NaNs, infinities,
+errors that the policy may want to have raised) before they do any arithmetic.
+This is fine for single values, but in tight loops the branches stop the
+compiler from generating straight-line (and, with a vector math library,
+vectorised) code.
+The functions in this file process arrays in blocks.
+For each block, they first compute the results for all elements without any
+branches, and then check, once per block, whether any result is non-finite.
+Only those elements are recomputed with the scalar implementation, which deals
+with the corner cases and raises errors as the \c Policy requires.
+The results are therefore exactly the same as those of the scalar operations.
+The conversion functions raise errors once per call rather than once per
+element.
+*/
+
+#ifndef MATH_LOG_FLOAT_ARRAY_HPP_INCLUDED
+#define MATH_LOG_FLOAT_ARRAY_HPP_INCLUDED
+
+#include <cmath>
+#include <cstddef>
+#include <algorithm>
+#include <exception>
+#include <limits>
+#include <thread>
+
+#include <boost/optional.hpp>
+
+#include "log-float.hpp"
+
+namespace math {
+
+namespace detail {
+
+    /**
+    Number of elements that array operations process at once.
+    The intermediate results for one block are kept on the stack.
+    */
+    static std::size_t constexpr log_float_array_block_size = 256;
+
+    /**
+    \return \c true iff none of the \a size elements starting at \a values is
+    infinite or NaN.
+    This does not branch per element.
+    */
+    template <class RealType>
+        inline bool all_finite (RealType const * values, std::size_t size)
+    {
+        // x - x is 0 for finite x, and NaN for infinite or NaN x.
+        RealType check = 0;
+        for (std::size_t i = 0; i != size; ++ i)
+            check += values [i] - values [i];
+        return check == 0;
+    }
+
+    /**
+    Add two blocks of exponents without dealing with corner cases.
+    Where both inputs are equal infinities, or either is NaN, the result is NaN.
+    Where the result overflows, it is infinite.
+    For all other inputs, the result is exactly what add_log_float returns.
+    */
+    template <class RealType, class Policy>
+        inline void add_log_float_block_unchecked (
+            RealType const * loga, RealType const * logb, RealType * result,
+            std::size_t size, Policy const & policy)
+    {
+        using std::abs;
+        using std::max;
+        for (std::size_t i = 0; i != size; ++ i) {
+            RealType greatest = (max) (loga [i], logb [i]);
+            RealType difference = -abs (loga [i] - logb [i]);
+            result [i] = greatest + log1p_exp (difference, policy);
+        }
+    }
+
+} // namespace detail
+
+/**
+Add two arrays of log_float element-wise.
+For each \c i in <c>[0, last1 - first1)</c>, this sets <c>result [i]</c> to
+<c>first1 [i] + first2 [i]</c>.
+The results are exactly the same as those of \c operator+, and errors are
+raised according to \a Policy in the same way.
+
+The main loop does not contain any branches, so that it can be vectorised if
+the compiler has vectorised versions of \c exp and \c log1p available.
+Corner cases (zeros added to zeros, infinities, NaNs, and overflow) are dealt
+with by the scalar implementation, only for the elements that need it.
+
+\a result may be equal to \a first1 or \a first2, for in-place operation.
+Otherwise, the output range must not overlap the input ranges.
+
+\return <c>result + (last1 - first1)</c>.
+*/
+template <class Exponent, class Policy>
+    inline log_float <Exponent, Policy> * add (
+        log_float <Exponent, Policy> const * first1,
+        log_float <Exponent, Policy> const * last1,
+        log_float <Exponent, Policy> const * first2,
+        log_float <Exponent, Policy> * result)
+{
+    std::size_t constexpr block_size = detail::log_float_array_block_size;
+    Exponent loga [block_size];
+    Exponent logb [block_size];
+    Exponent sum [block_size];
+
+    while (first1 != last1) {
+        std::size_t size = (std::min) (
+            std::size_t (last1 - first1), block_size);
+
+        for (std::size_t i = 0; i != size; ++ i) {
+            loga [i] = first1 [i].exponent();
+            logb [i] = first2 [i].exponent();
+        }
+
+        detail::add_log_float_block_unchecked (
+            loga, logb, sum, size, Policy());
+
+        if (!detail::all_finite (sum, size)) {
+            // Cold path: redo the non-finite elements with full error
+            // handling.
+            for (std::size_t i = 0; i != size; ++ i) {
+                if (!(boost::math::isfinite) (sum [i]))
+                    sum [i] = detail::add_log_float (
+                        loga [i], logb [i], Policy());
+            }
+        }
+
+        for (std::size_t i = 0; i != size; ++ i)
+            result [i] = log_float <Exponent, Policy> (sum [i], as_exponent());
+
+        first1 += size;
+        first2 += size;
+        result += size;
+    }
+    return result;
+}
+
+/**
+Convert an array of values into an array of log_float.
+For each \c i in <c>[0, last - first)</c>, this sets <c>result [i]</c> to
+<c>log_float \<Exponent, Policy> (first [i])</c>, with one difference: if
+values are negative, the domain error is raised according to \a Policy only
+once per call, and the value that the policy returns is used for all negative
+values.
+NaNs result in NaNs.
+
+The main loop does not contain any branches, so that it can be vectorised if
+the compiler has a vectorised version of \c log available.
+
+\a result must not overlap the input range.
+
+\return <c>result + (last - first)</c>.
+*/
+template <class Exponent, class Policy>
+    inline log_float <Exponent, Policy> * to_log_float (
+        Exponent const * first, Exponent const * last,
+        log_float <Exponent, Policy> * result)
+{
+    using std::log;
+    std::size_t constexpr block_size = detail::log_float_array_block_size;
+    Exponent exponents [block_size];
+    // Set when the domain error has been raised.
+    bool domain_error_raised = false;
+    Exponent replacement = 0;
+
+    while (first != last) {
+        std::size_t size = (std::min) (
+            std::size_t (last - first), block_size);
+
+        bool any_negative = false;
+        for (std::size_t i = 0; i != size; ++ i) {
+            exponents [i] = log (first [i]);
+            any_negative |= (first [i] < 0);
+        }
+
+        if (any_negative) {
+            // Cold path.
+            for (std::size_t i = 0; i != size; ++ i) {
+                if (first [i] < 0) {
+                    if (!domain_error_raised) {
+                        replacement = raise_domain_error (
+                            "math::to_log_float<%1%>",
+                            "log_float cannot contain negative number %1%",
+                            first [i], Policy());
+                        domain_error_raised = true;
+                    }
+                    exponents [i] = replacement;
+                }
+            }
+        }
+
+        for (std::size_t i = 0; i != size; ++ i) {
+            result [i] = log_float <Exponent, Policy> (
+                exponents [i], as_exponent());
+        }
+
+        first += size;
+        result += size;
+    }
+    return result;
+}
+
+/**
+Convert an array of log_float into an array of values.
+For each \c i in <c>[0, last - first)</c>, this sets <c>result [i]</c> to
+<c>first [i].get()</c>, with one difference: underflow and overflow errors are
+raised according to \a Policy at most once per call each.
+
+The main loop does not contain any branches, so that it can be vectorised if
+the compiler has a vectorised version of \c exp available.
+
+\a result must not overlap the input range.
+
+\return <c>result + (last - first)</c>.
+*/
+template <class Exponent, class Policy>
+    inline Exponent * from_log_float (
+        log_float <Exponent, Policy> const * first,
+        log_float <Exponent, Policy> const * last, Exponent * result)
+{
+    using std::exp;
+    static const char * function_name = "math::from_log_float<%1%>";
+    Exponent const infinity = std::numeric_limits <Exponent>::infinity();
+    bool any_underflow = false;
+    bool any_overflow = false;
+
+    for (; first != last; ++ first, ++ result) {
+        Exponent exponent = first->exponent();
+        Exponent value = exp (exponent);
+        any_underflow |= (value == 0) & (exponent != -infinity);
+        any_overflow |= (value == infinity) & (exponent != infinity);
+        *result = value;
+    }
+
+    if (any_underflow) {
+        raise_underflow_error <Exponent> (function_name,
+            "value cannot be represented except by 0", Policy());
+    }
+    if (any_overflow) {
+        raise_overflow_error <Exponent> (function_name,
+            "value cannot be represented except by infinity", Policy());
+    }
+    return result;
+}
+
+namespace detail {
+
+    /**
+    Number of elements below which pairwise_sum adds sequentially.
+    */
+    static std::size_t constexpr pairwise_sum_leaf_size = 8;
+
+    /**
+    Number of elements below which pairwise_sum does not start a new thread.
+    */
+    static std::size_t constexpr pairwise_sum_thread_size = 1 << 14;
+
+} // namespace detail
+
+/**
+Sum an array of log_float or signed_log_float with pairwise summation.
+
+The array is split into two halves, whose sums are computed recursively and
+then added; short arrays are summed sequentially.
+The rounding error then grows with the logarithm of the number of elements
+rather than linearly, as it does when adding the values one by one.
+
+The shape of the tree depends only on the number of elements.
+The result is therefore deterministic: sums of subranges of the tree can be
+computed on different threads, and the result will be bit-for-bit the same.
+The overload that takes a number of threads does this.
+The additions use the normal \c operator+, so special values and errors are
+dealt with in the same way.
+
+For a single-pass alternative that is even more accurate and cheaper, but only
+for log_float, see log_sum_accumulator.
+
+\return The sum of the elements in <c>[first, last)</c>, or 0 if the range is
+empty.
+*/
+template <class LogFloat>
+    inline LogFloat pairwise_sum (LogFloat const * first, LogFloat const * last)
+{
+    std::size_t size = last - first;
+    if (size <= detail::pairwise_sum_leaf_size) {
+        LogFloat result;
+        for (; first != last; ++ first)
+            result += *first;
+        return result;
+    }
+    LogFloat const * middle = first + size / 2;
+    return LogFloat (
+        pairwise_sum (first, middle) + pairwise_sum (middle, last));
+}
+
+/**
+Sum an array of log_float or signed_log_float with pairwise summation, on up to
+\a thread_num threads.
+
+The tree is the same as for the overload without \a thread_num.
+Its top levels are split between threads: the first half of each range is
+summed on a new thread and the second half on the current one, until
+\a thread_num threads are in use or the ranges become short.
+The result is therefore bit-for-bit the same as that of the sequential
+overload, whatever the number of threads.
+
+If an addition throws an exception, it is propagated to the caller once all
+threads have finished.
+
+\param thread_num The maximum number of threads to use, including the current
+    thread.
+    If this is 0, std::thread::hardware_concurrency() is used.
+\return The sum of the elements in <c>[first, last)</c>, or 0 if the range is
+empty.
+*/
+template <class LogFloat>
+    inline LogFloat pairwise_sum (LogFloat const * first, LogFloat const * last,
+        std::size_t thread_num)
+{
+    if (thread_num == 0)
+        thread_num = (std::max) (std::thread::hardware_concurrency(), 1u);
+    std::size_t size = last - first;
+    if (thread_num == 1 || size < detail::pairwise_sum_thread_size)
+        return pairwise_sum (first, last);
+
+    // Split the range in the same place as the sequential overload does.
+    LogFloat const * middle = first + size / 2;
+    boost::optional <LogFloat> left, right;
+    std::exception_ptr left_error, right_error;
+    std::thread thread ([&]() {
+            try {
+                left.emplace (pairwise_sum (first, middle, thread_num / 2));
+            } catch (...) {
+                left_error = std::current_exception();
+            }
+        });
+    try {
+        right.emplace (pairwise_sum (
+            middle, last, thread_num - thread_num / 2));
+    } catch (...) {
+        right_error = std::current_exception();
+    }
+    thread.join();
+
+    if (left_error)
+        std::rethrow_exception (left_error);
+    if (right_error)
+        std::rethrow_exception (right_error);
+    return LogFloat (*left + *right);
+}
+
+} // namespace math
+
+#endif // MATH_LOG_FLOAT_ARRAY_HPP_INCLUDED
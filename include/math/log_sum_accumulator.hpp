@@ -0,0 +1,190 @@
+/*
+Copyright 2026 Rogier van Dalen.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+/** \file
+Define log_sum_accumulator, which sums many log_float values with one \c exp
+per value.
+*/
+
+#ifndef MATH_LOG_SUM_ACCUMULATOR_HPP_INCLUDED
+#define MATH_LOG_SUM_ACCUMULATOR_HPP_INCLUDED
+
+#include <cmath>
+#include <limits>
+
+#include "log-float.hpp"
+
+namespace math {
+
+/** \brief
+Accumulator for the sum of many log_float values.
+
+Adding \c n values with <c>operator+=</c> on log_float costs \c n calls to
+\c exp and \c n calls to \c log1p.
+This class instead keeps the greatest exponent seen so far, \f$ m \f$, and the
+sum in the linear domain of all values scaled by \f$ \exp(-m) \f$.
+Each value that is added costs one \c exp.
+Only when the maximum increases is the sum rescaled, which costs one more
+\c exp.
+The result is computed with one \c log.
+
+The scaled sum is always in \f$ [1, n] \f$ once a non-zero value has been
+added, so it cannot overflow or underflow in practice.
+It uses compensated (Kahan) summation, so that the error does not grow with the
+number of values.
+
+Accuracy: let \f$ \epsilon \f$ be the machine epsilon of \a Exponent, and \c r
+the number of times the maximum increased.
+Apart from the error that \c exp makes on each term, the relative error of the
+scaled sum is at most \f$ (2 + 2r) \epsilon \f$ (to first order).
+This is the absolute error in the exponent of the result.
+For results with an exponent of magnitude at least 1, this is at most
+\f$ 2 + 2r \f$ units in the last place, plus one for the final addition.
+Summing with repeated <c>operator+</c>, on the other hand, makes an error of
+about one unit in the last place of the exponent per addition.
+Adding values in decreasing order leads to \f$ r = 0 \f$.
+(Compiling with flags like \c -ffast-math that allow the compiler to reorder
+floating-point operations removes the compensation.)
+
+Special values are dealt with as for log_float:
+zeros are ignored; if any value is infinite, the result is infinite; if any value
+is NaN, the result is NaN.
+If the result overflows, an overflow error is raised according to \a Policy.
+
+\tparam Exponent The exponent type of the result.
+\tparam Policy The Boost.Math policy for error handling.
+*/
+template <class Exponent = double, class Policy = policy<>>
+    class log_sum_accumulator
+{
+    // The greatest exponent seen so far.
+    Exponent maximum_;
+    // The sum of exp (exponent - maximum_) for all values.
+    Exponent scaled_sum_;
+    // The compensation term for Kahan summation of scaled_sum_.
+    // The exact sum is approximately scaled_sum_ - compensation_.
+    Exponent compensation_;
+
+    void add_scaled (Exponent term) {
+        Exponent corrected = term - compensation_;
+        Exponent new_sum = scaled_sum_ + corrected;
+        compensation_ = (new_sum - scaled_sum_) - corrected;
+        scaled_sum_ = new_sum;
+    }
+
+    /**
+    Make \a new_maximum the maximum, rescaling the current sum.
+    \pre new_maximum > maximum_
+    */
+    void rescale (Exponent new_maximum) {
+        using std::exp;
+        // If maximum_ is -infinity, then the factor is 0.
+        Exponent factor = exp (maximum_ - new_maximum);
+        scaled_sum_ *= factor;
+        compensation_ *= factor;
+        maximum_ = new_maximum;
+    }
+
+    /**
+    Add a value exp (exponent) multiplied by (linear_sum - linear_compensation).
+    */
+    void add_exponent (Exponent exponent, Exponent linear_sum,
+        Exponent linear_compensation)
+    {
+        using std::exp;
+        if (exponent < maximum_) {
+            Exponent factor = exp (exponent - maximum_);
+            add_scaled (factor * linear_sum);
+            add_scaled (- factor * linear_compensation);
+        } else if (exponent > maximum_) {
+            rescale (exponent);
+            add_scaled (linear_sum);
+            add_scaled (- linear_compensation);
+        } else if (exponent == maximum_) {
+            // If both are infinity, the sum does not change.
+            if ((boost::math::isfinite) (exponent)) {
+                add_scaled (linear_sum);
+                add_scaled (- linear_compensation);
+            }
+        } else {
+            // Either is NaN: the result will be NaN.
+            maximum_ = std::numeric_limits <Exponent>::quiet_NaN();
+        }
+    }
+
+public:
+    /// \brief The exponent type of the result.
+    typedef Exponent exponent_type;
+    /// \brief The error policy.
+    typedef Policy policy_type;
+
+    /// Initialise with the sum 0.
+    log_sum_accumulator()
+    : maximum_ (-std::numeric_limits <Exponent>::infinity()),
+        scaled_sum_ (0), compensation_ (0) {}
+
+    /// Add a value.
+    template <class OtherExponent>
+        log_sum_accumulator & operator += (
+            log_float <OtherExponent, Policy> const & value)
+    {
+        using std::exp;
+        Exponent exponent = value.exponent();
+        // Most values will be below the maximum.
+        if (exponent < maximum_)
+            add_scaled (exp (exponent - maximum_));
+        else
+            add_exponent (exponent, 1, 0);
+        return *this;
+    }
+
+    /// Add the sum accumulated by another accumulator.
+    template <class OtherExponent>
+        log_sum_accumulator & operator += (
+            log_sum_accumulator <OtherExponent, Policy> const & other)
+    {
+        // An empty accumulator has -infinity as maximum and does not change
+        // the sum.
+        add_exponent (other.maximum_, other.scaled_sum_, other.compensation_);
+        return *this;
+    }
+
+    /**
+    \return The sum of all values that have been added.
+    */
+    log_float <Exponent, Policy> sum() const {
+        if (!(boost::math::isfinite) (maximum_))
+            // 0, infinity, or NaN.
+            return log_float <Exponent, Policy> (maximum_, as_exponent());
+
+        using std::log;
+        Exponent result = maximum_ + log (scaled_sum_ - compensation_);
+        if (result == std::numeric_limits <Exponent>::infinity()) {
+            result = raise_overflow_error <Exponent> (
+                "log_sum_accumulator<%1%>::sum",
+                "Result of addition has overflowed", Policy());
+        }
+        return log_float <Exponent, Policy> (result, as_exponent());
+    }
+
+private:
+    template <class OtherExponent, class OtherPolicy>
+        friend class log_sum_accumulator;
+};
+
+} // namespace math
+
+#endif // MATH_LOG_SUM_ACCUMULATOR_HPP_INCLUDED
@@ -103,11 +103,13 @@ struct right;
 /** \struct opposite_direction
 Reverse a direction type.
 <c>opposite_direction<math::left>::type</c> is \c math::right and vice versa.
+<c>opposite_direction<math::either>::type</c> is \c math::either.
 */
 template <class Direction> struct opposite_direction;
 
 template <> struct opposite_direction <left> { typedef right type; };
 template <> struct opposite_direction <right> { typedef left type; };
+template <> struct opposite_direction <either> { typedef either type; };
 
 /**
 Metafunction.
@@ -367,6 +369,24 @@ namespace detail {
         struct magma_tag_all_implementation <MagmaTag, MagmaTag, Other ...>
     : magma_tag_all_implementation <MagmaTag, Other ...> {};
 
+    /**
+    The type of the result of applying \a Operation to \a Arguments from left
+    to right.
+    */
+    template <class Operation, class ... Arguments>
+        struct left_to_right_result;
+
+    template <class Operation, class Argument>
+        struct left_to_right_result <Operation, Argument>
+    { typedef typename std::decay <Argument>::type type; };
+
+    template <class Operation, class Argument1, class Argument2,
+            class ... Arguments>
+        struct left_to_right_result <
+            Operation, Argument1, Argument2, Arguments ...>
+    : left_to_right_result <Operation, typename std::result_of <
+        Operation const (Argument1, Argument2)>::type, Arguments ...> {};
+
 } // namespace detail
 
 /**
@@ -835,6 +855,27 @@ namespace operation {
         choose_by_order <order <MagmaTag, callable::times>>,
         unimplemented>::type {};
 
+    /**
+    Multiply more than two values, from left to right, with
+    <c>times \<MagmaTag></c>.
+    \internal
+    This is implemented lower down.
+    */
+    template <class MagmaTag> struct times_left_to_right;
+
+    /**
+    Implement multiplication of more than two values, which math::times is
+    called with as <c>times (a, b, c, ...)</c>.
+    By default, this multiplies the values from left to right.
+    Specialise this if the magma can do this more efficiently, for example by
+    allocating memory for the result only once.
+    */
+    template <class MagmaTag, class Enable = void> struct n_ary_times
+    : boost::mpl::if_ <
+        is_implemented <times <MagmaTag>>,
+        times_left_to_right <MagmaTag>,
+        unimplemented>::type {};
+
     /**
     Implement addition of two values.
     Specialise this if the addition operation exists for the magma.
@@ -1075,6 +1116,11 @@ namespace apply {
 
 #undef MATH_MAGMA_DEFINE_BINARY_OPERATION
 
+    template <class Magma1, class Magma2, class Magma3, class ... Magmas>
+        struct times <Magma1, Magma2, Magma3, Magmas ...>
+    : operation::n_ary_times <typename magma_tag_all <
+        Magma1, Magma2, Magma3, Magmas ...>::type> {};
+
     template <class Direction, class Magma1, class Magma2>
         struct divide <Direction, Magma1, Magma2>
     : operation::divide <typename magma_tag_all <Magma1, Magma2>::type,
@@ -1690,6 +1736,41 @@ namespace operation {
             std::forward <Left> (left), std::forward <Right> (right)));
     };
 
+    template <class MagmaTag> struct times_left_to_right {
+    private:
+        typedef times <MagmaTag> operation_type;
+
+        template <class Argument> typename std::decay <Argument>::type
+            apply (Argument && argument) const
+        { return std::forward <Argument> (argument); }
+
+        template <class Argument1, class Argument2, class ... Arguments>
+            typename detail::left_to_right_result <operation_type,
+                Argument1, Argument2, Arguments ...>::type
+            apply (Argument1 && argument1, Argument2 && argument2,
+                Arguments && ... arguments) const
+        {
+            return apply (operation_type() (
+                    std::forward <Argument1> (argument1),
+                    std::forward <Argument2> (argument2)),
+                std::forward <Arguments> (arguments) ...);
+        }
+
+    public:
+        template <class Argument1, class Argument2, class Argument3,
+                class ... Arguments>
+            typename detail::left_to_right_result <operation_type,
+                Argument1, Argument2, Argument3, Arguments ...>::type
+            operator() (Argument1 && argument1, Argument2 && argument2,
+                Argument3 && argument3, Arguments && ... arguments) const
+        {
+            return apply (std::forward <Argument1> (argument1),
+                std::forward <Argument2> (argument2),
+                std::forward <Argument3> (argument3),
+                std::forward <Arguments> (arguments) ...);
+        }
+    };
+
 } // namespace operation
 
 namespace is {
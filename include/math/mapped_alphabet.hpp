@@ -0,0 +1,468 @@
+/*
+Copyright 2026 Rogier van Dalen.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+
+/** \file
+Store the normal symbols of an alphabet of strings in a file that can be mapped
+into memory.
+
+The file contains a pool with the bytes of all symbols, a table with the offset
+of each symbol in the pool, and a hash table from symbols to their ids.
+Opening an alphabet over the file does not read or parse the symbols: the pages
+of the file are read only when they are used, and processes that open the same
+file share them.
+*/
+
+#ifndef MATH_MAPPED_ALPHABET_HPP_INCLUDED
+#define MATH_MAPPED_ALPHABET_HPP_INCLUDED
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <atomic>
+#include <fstream>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <boost/interprocess/file_mapping.hpp>
+#include <boost/interprocess/mapped_region.hpp>
+
+#include "alphabet.hpp"
+
+namespace math {
+
+/**
+Exception that is thrown when an alphabet file cannot be read or written, or is
+not in the right format.
+*/
+class alphabet_file_error : public std::runtime_error {
+public:
+    explicit alphabet_file_error (std::string const & message)
+    : std::runtime_error (message) {}
+};
+
+namespace detail {
+
+    /**
+    Header at the start of an alphabet file.
+    It is followed by:
+    \li the offsets of the symbols in the pool: \c symbol_num + 1 numbers of
+        type \c std::uint64_t;
+    \li the hash table: \c slot_num objects of type alphabet_file_slot;
+    \li the pool: \c pool_size bytes.
+
+    All numbers are stored in the byte order of the machine that wrote the file.
+    */
+    struct alphabet_file_header {
+        char magic [8];
+        std::uint32_t version;
+        // Reads as alphabet_file_byte_order only with the right byte order.
+        std::uint32_t byte_order;
+        std::uint64_t symbol_num;
+        // A power of two, greater than symbol_num.
+        std::uint64_t slot_num;
+        std::uint64_t pool_size;
+    };
+
+    static char const alphabet_file_magic [8] =
+        {'m', 'a', 't', 'h', 'a', 'l', 'p', 'h'};
+    static std::uint32_t constexpr alphabet_file_version = 1;
+    static std::uint32_t constexpr alphabet_file_byte_order = 0x01020304;
+
+    /**
+    Slot in the hash table of an alphabet file.
+    The hash table uses linear probing.
+    */
+    struct alphabet_file_slot {
+        std::uint64_t hash;
+        std::uint64_t dense;
+    };
+
+    static std::uint64_t constexpr alphabet_file_empty_slot =
+        ~std::uint64_t (0);
+
+    /**
+    Hash function for symbols in alphabet files.
+    This is FNV-1a, which, unlike boost::hash, gives the same results on all
+    machines and with all versions of Boost, so that the hash table can be
+    stored in the file.
+    */
+    inline std::uint64_t alphabet_file_hash (
+        char const * data, std::size_t size)
+    {
+        std::uint64_t hash = 0xcbf29ce484222325ull;
+        for (std::size_t index = 0; index != size; ++ index) {
+            hash ^= std::uint64_t (static_cast <unsigned char> (data [index]));
+            hash *= 0x100000001b3ull;
+        }
+        return hash;
+    }
+
+    /// \return The first slot to look in for a symbol with \a hash.
+    inline std::uint64_t alphabet_file_first_position (
+        std::uint64_t hash, std::uint64_t slot_num)
+    {
+        std::uint64_t mixed = hash * 0x9E3779B97F4A7C15ull;
+        return (mixed ^ (mixed >> 32)) & (slot_num - 1);
+    }
+
+    /**
+    Map of strings to dense values, of which the first part is in a file mapped
+    into memory, and the rest in a hashed_symbol_mapping.
+
+    The symbols in the file are kept as bytes, so get_symbol() constructs a
+    \c std::string the first time it is called for a symbol.
+    This uses an atomic compare-and-exchange, so that, like the other
+    operations, it does not need a lock.
+    Symbols are looked up as \c boost::string_ref, so that keys of other types
+    than \c std::string do not need to be converted.
+    */
+    template <class DenseValue>
+        class normal_symbol_mapping <std::string, DenseValue,
+            mapped_symbol_mapping>
+    {
+        boost::interprocess::file_mapping file;
+        boost::interprocess::mapped_region region;
+
+        // These point into the file, and are set by open().
+        std::uint64_t const * offsets;
+        alphabet_file_slot const * slots;
+        std::uint64_t slot_num;
+        char const * pool;
+        std::uint64_t pool_size;
+
+        DenseValue file_symbol_num;
+
+        // The symbols from the file that get_symbol() has been called for.
+        std::unique_ptr <std::atomic <std::string const *> []> strings;
+
+        // Symbols that have been added after the file was opened.
+        normal_symbol_mapping <std::string, DenseValue, hashed_symbol_mapping>
+            added;
+
+        static void check (bool condition, std::string const & file_name,
+            char const * problem)
+        {
+            if (!condition)
+                throw alphabet_file_error (
+                    "Alphabet file \"" + file_name + "\" " + problem);
+        }
+
+        /**
+        Map \a file_name into memory, check the header, and set the pointers to
+        the parts of the file.
+        \return The number of symbols in the file.
+        */
+        DenseValue open (std::string const & file_name,
+            DenseValue max_symbol_num)
+        {
+            namespace interprocess = boost::interprocess;
+            try {
+                file = interprocess::file_mapping (
+                    file_name.c_str(), interprocess::read_only);
+                region = interprocess::mapped_region (
+                    file, interprocess::read_only);
+            } catch (interprocess::interprocess_exception & error) {
+                throw alphabet_file_error ("Alphabet file \"" + file_name
+                    + "\" cannot be mapped: " + error.what());
+            }
+
+            char const * begin = static_cast <char const *> (
+                region.get_address());
+            std::uint64_t size = region.get_size();
+
+            check (size >= sizeof (alphabet_file_header), file_name,
+                "is too short.");
+            alphabet_file_header const & header =
+                *reinterpret_cast <alphabet_file_header const *> (begin);
+            check (std::memcmp (header.magic, alphabet_file_magic,
+                    sizeof (alphabet_file_magic)) == 0,
+                file_name, "is not an alphabet file.");
+            check (header.version == alphabet_file_version,
+                file_name, "has an unknown version.");
+            check (header.byte_order == alphabet_file_byte_order,
+                file_name, "has the wrong byte order.");
+            check (header.slot_num != 0
+                && (header.slot_num & (header.slot_num - 1)) == 0
+                && header.symbol_num < header.slot_num,
+                file_name, "has a hash table of the wrong size.");
+
+            // Check the sizes of the parts one by one, to prevent overflow.
+            std::uint64_t remaining = size - sizeof (alphabet_file_header);
+            check (header.symbol_num < remaining / sizeof (std::uint64_t),
+                file_name, "is too short for its offsets.");
+            remaining -= (header.symbol_num + 1) * sizeof (std::uint64_t);
+            check (header.slot_num <= remaining / sizeof (alphabet_file_slot),
+                file_name, "is too short for its hash table.");
+            remaining -= header.slot_num * sizeof (alphabet_file_slot);
+            check (header.pool_size <= remaining,
+                file_name, "is too short for its symbols.");
+
+            if (header.symbol_num > max_symbol_num)
+                throw alphabet_overflow();
+
+            offsets = reinterpret_cast <std::uint64_t const *> (
+                begin + sizeof (alphabet_file_header));
+            slots = reinterpret_cast <alphabet_file_slot const *> (
+                offsets + header.symbol_num + 1);
+            slot_num = header.slot_num;
+            pool = reinterpret_cast <char const *> (slots + slot_num);
+            pool_size = header.pool_size;
+            check (offsets [header.symbol_num] == pool_size,
+                file_name, "has the wrong offsets.");
+            return DenseValue (header.symbol_num);
+        }
+
+        /**
+        \return The offset of the symbol with id \a dense in the pool, and set
+        \a size to its length.
+        The offsets are checked only here, when they are used.
+        */
+        char const * file_symbol (std::uint64_t dense, std::size_t & size)
+            const
+        {
+            std::uint64_t begin = offsets [dense];
+            std::uint64_t end = offsets [dense + 1];
+            if (!(begin <= end && end <= pool_size))
+                throw alphabet_file_error ("Alphabet file is corrupt.");
+            size = std::size_t (end - begin);
+            return pool + begin;
+        }
+
+        /**
+        \return The id of \a symbol, which has hash value \a hash, in the
+        file, or alphabet_file_empty_slot.
+        \throw alphabet_file_error If the hash table has no empty slot, which
+            a correct file always has.
+        */
+        std::uint64_t find_in_file (boost::string_ref symbol,
+            std::uint64_t hash) const
+        {
+            std::uint64_t position = alphabet_file_first_position (
+                hash, slot_num);
+            for (std::uint64_t probe = 0; probe != slot_num; ++ probe) {
+                alphabet_file_slot const & slot = slots [position];
+                if (slot.dense == alphabet_file_empty_slot)
+                    return alphabet_file_empty_slot;
+                if (slot.hash == hash && slot.dense < file_symbol_num) {
+                    std::size_t size;
+                    char const * data = file_symbol (slot.dense, size);
+                    if (size == symbol.size()
+                            && std::memcmp (data, symbol.data(), size) == 0)
+                        return slot.dense;
+                }
+                position = (position + 1) & (slot_num - 1);
+            }
+            throw alphabet_file_error ("Alphabet file is corrupt.");
+        }
+
+        std::uint64_t find_in_file (boost::string_ref symbol) const {
+            return find_in_file (symbol,
+                alphabet_file_hash (symbol.data(), symbol.size()));
+        }
+
+    public:
+        // The hash value in the file.
+        typedef std::uint64_t hash_type;
+
+        normal_symbol_mapping (DenseValue max_symbol_num,
+            std::string const & file_name)
+        : offsets (nullptr), slots (nullptr), slot_num (0), pool (nullptr),
+            pool_size (0), file_symbol_num (open (file_name, max_symbol_num)),
+            strings (new std::atomic <std::string const *> [
+                file_symbol_num]()),
+            added (max_symbol_num - file_symbol_num) {}
+
+        normal_symbol_mapping (normal_symbol_mapping const &) = delete;
+        normal_symbol_mapping & operator = (normal_symbol_mapping const &)
+            = delete;
+
+        ~normal_symbol_mapping() {
+            for (DenseValue dense = 0; dense != file_symbol_num; ++ dense)
+                delete strings [dense].load (std::memory_order_relaxed);
+        }
+
+        std::size_t size() const { return file_symbol_num + added.size(); }
+
+        DenseValue get_dense (boost::string_ref symbol) const {
+            std::uint64_t dense = find_in_file (symbol);
+            if (dense != alphabet_file_empty_slot)
+                return DenseValue (dense);
+            return file_symbol_num + added.get_dense (symbol);
+        }
+
+        std::string const & get_symbol (DenseValue const & dense_symbol) const
+        {
+            if (dense_symbol >= file_symbol_num)
+                return added.get_symbol (dense_symbol - file_symbol_num);
+
+            std::atomic <std::string const *> & cached =
+                strings [dense_symbol];
+            std::string const * result = cached.load (
+                std::memory_order_acquire);
+            if (!result) {
+                std::size_t size;
+                char const * data = file_symbol (dense_symbol, size);
+                std::unique_ptr <std::string> new_string (
+                    new std::string (data, size));
+                // Another thread may have done the same in the meantime.
+                if (cached.compare_exchange_strong (result, new_string.get(),
+                        std::memory_order_acq_rel))
+                    result = new_string.release();
+            }
+            return *result;
+        }
+
+        DenseValue add (std::string const & symbol) {
+            std::uint64_t dense = find_in_file (symbol);
+            if (dense != alphabet_file_empty_slot)
+                return DenseValue (dense);
+            return file_symbol_num + added.add (symbol);
+        }
+
+        hash_type hash (boost::string_ref symbol) const
+        { return alphabet_file_hash (symbol.data(), symbol.size()); }
+
+        void prefetch (hash_type hash) const {
+            detail::prefetch (
+                &slots [alphabet_file_first_position (hash, slot_num)]);
+        }
+
+        bool find (boost::string_ref symbol, hash_type hash,
+            DenseValue & dense) const
+        {
+            std::uint64_t in_file = find_in_file (symbol, hash);
+            if (in_file != alphabet_file_empty_slot) {
+                dense = DenseValue (in_file);
+                return true;
+            }
+            if (added.find (symbol, added.hash (symbol), dense)) {
+                dense += file_symbol_num;
+                return true;
+            }
+            return false;
+        }
+
+        /**
+        Add symbols that find() did not find.
+        Since the file does not change, they go straight to \c added.
+        */
+        void add (std::string const * const * new_symbols, hash_type const *,
+            std::size_t num, DenseValue * result)
+        {
+            typedef typename normal_symbol_mapping <std::string, DenseValue,
+                hashed_symbol_mapping>::hash_type added_hash_type;
+            std::vector <added_hash_type> added_hashes (num);
+            for (std::size_t index = 0; index != num; ++ index)
+                added_hashes [index] = added.hash (*new_symbols [index]);
+            added.add (new_symbols, added_hashes.data(), num, result);
+            for (std::size_t index = 0; index != num; ++ index)
+                result [index] += file_symbol_num;
+        }
+    };
+
+    template <class Output, class Value>
+        inline void write_alphabet_file_values (
+            Output & output, Value const * values, std::size_t num)
+    {
+        output.write (reinterpret_cast <char const *> (values),
+            std::streamsize (num * sizeof (Value)));
+    }
+
+} // namespace detail
+
+/**
+Write the normal symbols of an alphabet of strings to a file, so that it can be
+opened with an alphabet with mapped_symbol_mapping.
+The alphabet can use any symbol mapping.
+The dense symbols in the alphabet that is opened over the file are the same as
+in \a a.
+Special symbols are not written.
+
+The file is not portable between machines with a different byte order.
+
+\throw alphabet_file_error if the file cannot be written.
+*/
+template <class Tag, std::size_t max_normal_symbol_num,
+    class SpecialSymbols, std::size_t special_symbol_headroom,
+    class SymbolMapping>
+inline void write_alphabet_file (alphabet <std::string, Tag,
+        max_normal_symbol_num, SpecialSymbols, special_symbol_headroom,
+        SymbolMapping> const & a,
+    std::string const & file_name)
+{
+    typedef typename alphabet <std::string, Tag, max_normal_symbol_num,
+        SpecialSymbols, special_symbol_headroom, SymbolMapping>::dense_type
+        dense_type;
+    std::size_t symbol_num = a.normal_symbol_num();
+    auto symbol = [&a] (std::size_t index) -> std::string const & {
+        return a.template get_symbol <std::string> (
+            detail::dense_symbol_access::make <dense_type, Tag> (
+                dense_type (index)));
+    };
+
+    // Keep the hash table at most half full.
+    std::uint64_t slot_num = 16;
+    while (slot_num < 2 * std::uint64_t (symbol_num))
+        slot_num *= 2;
+
+    std::vector <std::uint64_t> offsets;
+    offsets.reserve (symbol_num + 1);
+    offsets.push_back (0);
+    std::vector <detail::alphabet_file_slot> slots (slot_num,
+        detail::alphabet_file_slot {0, detail::alphabet_file_empty_slot});
+
+    for (std::size_t index = 0; index != symbol_num; ++ index) {
+        std::string const & current = symbol (index);
+        offsets.push_back (offsets.back() + current.size());
+        std::uint64_t hash = detail::alphabet_file_hash (
+            current.data(), current.size());
+        std::uint64_t position = detail::alphabet_file_first_position (
+            hash, slot_num);
+        while (slots [position].dense != detail::alphabet_file_empty_slot)
+            position = (position + 1) & (slot_num - 1);
+        slots [position] = detail::alphabet_file_slot {hash, index};
+    }
+
+    detail::alphabet_file_header header;
+    std::memcpy (header.magic, detail::alphabet_file_magic,
+        sizeof (header.magic));
+    header.version = detail::alphabet_file_version;
+    header.byte_order = detail::alphabet_file_byte_order;
+    header.symbol_num = symbol_num;
+    header.slot_num = slot_num;
+    header.pool_size = offsets.back();
+
+    std::ofstream output (file_name.c_str(), std::ios::binary);
+    detail::write_alphabet_file_values (output, &header, 1);
+    detail::write_alphabet_file_values (
+        output, offsets.data(), offsets.size());
+    detail::write_alphabet_file_values (output, slots.data(), slots.size());
+    for (std::size_t index = 0; index != symbol_num; ++ index) {
+        std::string const & current = symbol (index);
+        output.write (current.data(), std::streamsize (current.size()));
+    }
+    output.close();
+    if (!output)
+        throw alphabet_file_error (
+            "Alphabet file \"" + file_name + "\" could not be written.");
+}
+
+} // namespace math
+
+#endif // MATH_MAPPED_ALPHABET_HPP_INCLUDED
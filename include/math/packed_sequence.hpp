@@ -0,0 +1,401 @@
+/*
+Copyright 2026 Rogier van Dalen.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+
+/** \file
+Define packed_sequence, which stores a sequence of dense symbols in fewer bits
+per symbol, and symbol_packing, which says how many.
+*/
+
+#ifndef MATH_PACKED_SEQUENCE_HPP_INCLUDED
+#define MATH_PACKED_SEQUENCE_HPP_INCLUDED
+
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <algorithm>
+#include <limits>
+#include <stdexcept>
+#include <type_traits>
+#include <vector>
+
+#include "alphabet.hpp"
+#include "sequence.hpp"
+
+namespace math {
+
+namespace detail {
+
+    /// \return The number of bits needed to represent \a value.
+    template <class Unsigned> inline unsigned bit_width (Unsigned value) {
+        unsigned width = 0;
+        for (; value != 0; value >>= 1)
+            ++ width;
+        return width;
+    }
+
+    /// \return The index of the lowest bit that is set in \a value.
+    /// \pre <c>value != 0</c>.
+    inline unsigned lowest_set_bit (std::uint64_t value) {
+        assert (value != 0);
+#if defined (__GNUC__)
+        return unsigned (__builtin_ctzll (value));
+#else
+        unsigned index = 0;
+        for (; !(value & 1); value >>= 1)
+            ++ index;
+        return index;
+#endif
+    }
+
+} // namespace detail
+
+/** \brief
+How packed_sequence stores dense symbols: the id that is stored as zero, and
+the number of bits per symbol.
+
+Each symbol is stored as the offset of its id from lowest(), in
+bits_per_symbol() bits.
+Packed sequences can be compared one 64-bit word at a time only if they have
+the same packing.
+Therefore, all sequences of symbols from one alphabet should normally be
+packed with one packing, constructed from the alphabet.
+
+\tparam Value The integer type of the ids of the dense symbols.
+*/
+template <class Value> class symbol_packing {
+    typedef typename std::make_unsigned <Value>::type unsigned_type;
+    static unsigned constexpr full_width =
+        std::numeric_limits <unsigned_type>::digits;
+
+    Value lowest_;
+    unsigned bits_per_symbol_;
+
+public:
+    /**
+    Construct the packing that stores any id at the full width of Value.
+    This saves no memory, and is used for sequences without symbols.
+    */
+    symbol_packing()
+    : lowest_ (std::numeric_limits <Value>::min()),
+        bits_per_symbol_ (full_width) {}
+
+    /**
+    Construct a packing with a lowest id and a width given at run time.
+    \pre <c>bits_per_symbol</c> is not greater than the number of bits in
+    Value.
+    */
+    symbol_packing (Value lowest, unsigned bits_per_symbol)
+    : lowest_ (lowest), bits_per_symbol_ (bits_per_symbol)
+    { assert (bits_per_symbol <= full_width); }
+
+    /**
+    Construct the packing for the symbols of an alphabet.
+    This makes room for all the special symbols that the alphabet type allows
+    (\a special_symbol_headroom), and for the normal symbols that the alphabet
+    contains now.
+    The packing is therefore the same for all alphabets that share normal
+    symbols.
+    Normal symbols that are added later may not fit.
+    */
+    template <class NormalSymbol, class Tag, std::size_t max_normal_symbol_num,
+        class SpecialSymbols, std::size_t special_symbol_headroom,
+        class SymbolMapping>
+    explicit symbol_packing (alphabet <NormalSymbol, Tag, max_normal_symbol_num,
+        SpecialSymbols, special_symbol_headroom, SymbolMapping> const & a)
+    : lowest_ (Value (- unsigned_type (special_symbol_headroom))),
+        bits_per_symbol_ (detail::bit_width (unsigned_type (
+            special_symbol_headroom + a.normal_symbol_num() - 1)))
+    {
+        static_assert (std::is_same <Value, typename alphabet <NormalSymbol,
+                Tag, max_normal_symbol_num, SpecialSymbols,
+                special_symbol_headroom, SymbolMapping>::dense_type>::value,
+            "The packing must be for the dense type of the alphabet.");
+        if (special_symbol_headroom + a.normal_symbol_num() == 0)
+            bits_per_symbol_ = 0;
+    }
+
+    /// \return The id that is stored as zero.
+    Value lowest() const { return lowest_; }
+
+    /// \return The number of bits that each symbol takes.
+    unsigned bits_per_symbol() const { return bits_per_symbol_; }
+
+    /// \return \c true iff a symbol with id \a id can be stored.
+    bool contains (Value id) const {
+        return bits_per_symbol_ == full_width
+            || (unsigned_type (unsigned_type (id) - unsigned_type (lowest_))
+                >> bits_per_symbol_) == 0;
+    }
+
+    bool operator == (symbol_packing const & that) const {
+        return lowest_ == that.lowest_
+            && bits_per_symbol_ == that.bits_per_symbol_;
+    }
+
+    bool operator != (symbol_packing const & that) const
+    { return !(*this == that); }
+};
+
+template <class Symbol, class Direction = left> class packed_sequence;
+
+/** \brief
+Storage for a sequence of dense symbols that uses only as many bits per symbol
+as a symbol_packing gives.
+
+math::sequence stores each symbol as a full dense_symbol, which normally takes
+four bytes.
+This class instead stores each symbol in the number of bits that a
+symbol_packing gives.
+Normally, the packing is constructed from the alphabet, so that it covers all
+its symbols, and all sequences from the alphabet are packed the same way.
+For example, a sequence of words from a vocabulary of 65536 words takes 17 bits
+per symbol.
+16 bits would be enough for the normal symbols, but by default an alphabet
+reserves room for 128 special symbols (\c special_symbol_headroom), which
+have negative ids, and these need one more bit.
+Symbols fit in 16 bits if the number of words plus the headroom is at most
+65536.
+
+Like the classes in compact_log_float.hpp, this class only stores values.
+It converts implicitly to math::sequence, to compute with.
+It does provide comparison, and common_length, which computes the length of the
+common prefix (for left sequences) or suffix (for right sequences) one 64-bit
+word at a time when the two sequences have the same packing.
+For right sequences, the symbols are stored in reverse order, so that the
+suffix is at the start of the packed words.
+
+\tparam Symbol The symbol type, which must be a dense_symbol with a run-time
+    integer value.
+\tparam Direction The direction of the math::sequence that this converts to
+    and from.
+*/
+template <class Value, class Tag, class Direction>
+    class packed_sequence <dense_symbol <Value, Tag>, Direction>
+{
+    static_assert (std::is_integral <Value>::value,
+        "Only dense symbols with run-time values can be packed.");
+    static_assert (std::numeric_limits <Value>::digits < 64,
+        "Dense symbols must fit in 64 bits.");
+
+public:
+    /// The symbol type.
+    typedef dense_symbol <Value, Tag> symbol_type;
+    /// The type of sequence that this converts to and from.
+    typedef sequence <symbol_type, Direction> sequence_type;
+
+private:
+    typedef typename std::make_unsigned <Value>::type unsigned_type;
+    static unsigned constexpr word_bits = 64;
+
+    bool is_annihilator_;
+    std::size_t size_;
+    symbol_packing <Value> packing_;
+    // The symbols, from least significant bit up.
+    // Bits past the last symbol are zero.
+    std::vector <std::uint64_t> words_;
+
+    unsigned width() const { return packing_.bits_per_symbol(); }
+
+    static bool is_left() { return std::is_same <Direction, left>::value; }
+
+    std::uint64_t mask() const {
+        return width() == word_bits ? ~std::uint64_t (0)
+            : (std::uint64_t (1) << width()) - 1;
+    }
+
+    // Return the offset of the symbol at index in the storage order.
+    std::uint64_t get (std::size_t index) const {
+        if (width() == 0)
+            return 0;
+        std::size_t bit = index * width();
+        std::size_t word = bit / word_bits;
+        unsigned shift = unsigned (bit % word_bits);
+        std::uint64_t result = words_ [word] >> shift;
+        if (shift + width() > word_bits)
+            result |= words_ [word + 1] << (word_bits - shift);
+        return result & mask();
+    }
+
+    void set (std::size_t index, std::uint64_t value) {
+        if (width() == 0)
+            return;
+        std::size_t bit = index * width();
+        std::size_t word = bit / word_bits;
+        unsigned shift = unsigned (bit % word_bits);
+        words_ [word] |= value << shift;
+        if (shift + width() > word_bits)
+            words_ [word + 1] |= value >> (word_bits - shift);
+    }
+
+    // Convert an index in sequence order into one in storage order.
+    std::size_t storage_index (std::size_t index) const
+    { return is_left() ? index : size_ - 1 - index; }
+
+    symbol_type get_symbol (std::size_t storage_index) const {
+        return detail::dense_symbol_access::make <Value, Tag> (Value (
+            unsigned_type (packing_.lowest())
+            + unsigned_type (get (storage_index))));
+    }
+
+    template <class Value2, class Tag2, class Direction2>
+        friend std::size_t common_length (
+            packed_sequence <dense_symbol <Value2, Tag2>, Direction2> const &,
+            packed_sequence <dense_symbol <Value2, Tag2>, Direction2> const &);
+
+public:
+    /// Construct an empty sequence.
+    packed_sequence()
+    : is_annihilator_ (false), size_ (0) {}
+
+    /// Construct the annihilator.
+    packed_sequence (sequence_annihilator <symbol_type, Direction> const &)
+    : is_annihilator_ (true), size_ (0) {}
+
+    /**
+    Pack the symbols of a sequence.
+    \param s The sequence.
+    \param packing The packing, normally constructed from the alphabet.
+    \throw std::out_of_range If a symbol in \a s does not fit in \a packing.
+    */
+    packed_sequence (sequence_type const & s,
+        symbol_packing <Value> const & packing)
+    : is_annihilator_ (s.is_annihilator()), size_ (0), packing_ (packing)
+    {
+        if (is_annihilator_)
+            return;
+        auto const & symbols = s.storage();
+        size_ = symbols.size();
+
+        words_.resize ((size_ * width() + word_bits - 1) / word_bits, 0);
+        for (std::size_t index = 0; index != size_; ++ index) {
+            Value id = symbols.begin() [index].id();
+            if (!packing_.contains (id))
+                throw std::out_of_range (
+                    "Symbol does not fit in the packing of the sequence.");
+            set (storage_index (index), unsigned_type (
+                unsigned_type (id) - unsigned_type (packing_.lowest())));
+        }
+    }
+
+    /// Unpack into a math::sequence.
+    operator sequence_type () const {
+        if (is_annihilator_)
+            return sequence_annihilator <symbol_type, Direction>();
+        detail::sequence_storage <symbol_type> symbols (size_);
+        for (std::size_t index = 0; index != size_; ++ index)
+            symbols.push_back (get_symbol (storage_index (index)));
+        return sequence_type (std::move (symbols));
+    }
+
+    /// \return \c true iff this is the annihilator.
+    bool is_annihilator() const { return is_annihilator_; }
+
+    /// \return \c true iff this contains no symbols.
+    /// \pre This is not the annihilator.
+    bool empty() const {
+        assert (!is_annihilator_);
+        return size_ == 0;
+    }
+
+    /// \return The number of symbols.
+    /// \pre This is not the annihilator.
+    std::size_t size() const {
+        assert (!is_annihilator_);
+        return size_;
+    }
+
+    /// \return The symbol at position \a index.
+    /// \pre <c>index < size()</c>.
+    symbol_type operator[] (std::size_t index) const {
+        assert (index < size_);
+        return get_symbol (storage_index (index));
+    }
+
+    /// \return The packing that the symbols are stored with.
+    symbol_packing <Value> const & packing() const { return packing_; }
+
+    /// \return The number of bits that each symbol takes.
+    unsigned bits_per_symbol() const { return packing_.bits_per_symbol(); }
+
+    /// \return The number of bytes that the packed symbols take.
+    std::size_t packed_size() const
+    { return words_.size() * sizeof (std::uint64_t); }
+
+    /**
+    \return \c true iff the two sequences are equal.
+    If they have the same packing, this compares the packed words.
+    */
+    bool operator == (packed_sequence const & that) const {
+        if (is_annihilator_ || that.is_annihilator_)
+            return is_annihilator_ == that.is_annihilator_;
+        if (size_ != that.size_)
+            return false;
+        if (packing_ == that.packing_)
+            return words_ == that.words_;
+        return common_length (*this, that) == size_;
+    }
+
+    /// \return \c true iff the two sequences are not equal.
+    bool operator != (packed_sequence const & that) const
+    { return !(*this == that); }
+};
+
+/**
+\return The number of symbols that two packed sequences have in common at the
+start, for left sequences, or at the end, for right sequences.
+This is the length of the result of math::plus.
+If the sequences have the same packing, this compares one 64-bit word at a
+time.
+\pre Neither sequence is the annihilator.
+*/
+template <class Value, class Tag, class Direction> inline
+    std::size_t common_length (
+        packed_sequence <dense_symbol <Value, Tag>, Direction> const & packed1,
+        packed_sequence <dense_symbol <Value, Tag>, Direction> const & packed2)
+{
+    assert (!packed1.is_annihilator() && !packed2.is_annihilator());
+    std::size_t size = (std::min) (packed1.size_, packed2.size_);
+
+    if (packed1.packing_ != packed2.packing_) {
+        // The symbols are packed differently: compare them one by one.
+        std::size_t length = 0;
+        while (length != size && packed1.get_symbol (length)
+                == packed2.get_symbol (length))
+            ++ length;
+        return length;
+    }
+
+    if (packed1.bits_per_symbol() == 0)
+        return size;
+    std::size_t word_bits = 64;
+    std::size_t word_count = (size * packed1.bits_per_symbol() + word_bits - 1)
+        / word_bits;
+    for (std::size_t word = 0; word != word_count; ++ word) {
+        std::uint64_t difference =
+            packed1.words_ [word] ^ packed2.words_ [word];
+        if (difference != 0) {
+            std::size_t bit = word * word_bits
+                + detail::lowest_set_bit (difference);
+            return (std::min) (size, bit / packed1.bits_per_symbol());
+        }
+    }
+    return size;
+}
+
+} // namespace math
+
+#endif // MATH_PACKED_SEQUENCE_HPP_INCLUDED
@@ -0,0 +1,237 @@
+/*
+Copyright 2026 Rogier van Dalen.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+/** \file
+Define math::reduce, which combines the elements of a range with a magma
+operation, in parallel if the operation is associative.
+*/
+
+#ifndef MATH_REDUCE_HPP_INCLUDED
+#define MATH_REDUCE_HPP_INCLUDED
+
+#include <cassert>
+#include <cstddef>
+#include <algorithm>
+#include <exception>
+#include <iterator>
+#include <stdexcept>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include <boost/optional.hpp>
+
+#include "magma.hpp"
+
+namespace math {
+
+namespace detail {
+
+    /**
+    The default number of elements that one thread combines sequentially.
+    */
+    static std::size_t constexpr reduce_default_chunk_size = 4096;
+
+    template <class Range, class Operation> struct reduce_types {
+        typedef decltype (std::begin (std::declval <Range const &>()))
+            iterator;
+        typedef decltype (*std::declval <iterator>()) reference;
+        typedef typename std::decay <reference>::type value_type;
+        typedef typename std::decay <typename std::result_of <
+            Operation const (reference, reference)>::type>::type result_type;
+
+        // Chunks are only combined separately if this does not change the
+        // result.
+        // They are only processed in parallel if the iterator is
+        // random-access.
+        typedef std::integral_constant <bool,
+            is::associative <Operation, value_type>::value
+            && std::is_base_of <std::random_access_iterator_tag,
+                typename std::iterator_traits <iterator>::iterator_category
+            >::value> chunked;
+    };
+
+    /**
+    Join all joinable threads in a vector when this goes out of scope.
+    This makes sure that the threads are joined also if starting one of them
+    throws.
+    */
+    class join_threads {
+        std::vector <std::thread> & threads_;
+    public:
+        explicit join_threads (std::vector <std::thread> & threads)
+        : threads_ (threads) {}
+
+        join_threads (join_threads const &) = delete;
+        join_threads & operator = (join_threads const &) = delete;
+
+        ~join_threads() {
+            for (std::thread & thread : threads_) {
+                if (thread.joinable())
+                    thread.join();
+            }
+        }
+    };
+
+    /**
+    Combine the elements in [first, last) from left to right.
+    \pre first != last.
+    */
+    template <class Result, class Iterator, class Operation>
+        inline Result reduce_sequential (
+            Iterator first, Iterator last, Operation const & operation)
+    {
+        assert (first != last);
+        Result result (*first);
+        for (++ first; first != last; ++ first)
+            result = operation (std::move (result), *first);
+        return result;
+    }
+
+    template <class Result, class Iterator, class Operation>
+        inline Result reduce (Iterator first, Iterator last,
+            Operation const & operation, std::size_t, std::size_t,
+            std::false_type)
+    { return reduce_sequential <Result> (first, last, operation); }
+
+    /**
+    Split [first, last) into chunks of chunk_size elements; combine the
+    elements of each chunk, on a number of threads; and then combine the
+    results of the chunks, from left to right.
+    The result depends on the chunk size but not on the number of threads.
+    \pre first != last.
+    \pre chunk_size != 0.
+    */
+    template <class Result, class Iterator, class Operation>
+        inline Result reduce (Iterator first, Iterator last,
+            Operation const & operation, std::size_t chunk_size,
+            std::size_t thread_num, std::true_type)
+    {
+        assert (first != last);
+        assert (chunk_size != 0);
+        if (thread_num == 0)
+            thread_num = (std::max) (std::thread::hardware_concurrency(), 1u);
+        std::size_t size = last - first;
+        std::size_t chunk_count = (size + chunk_size - 1) / chunk_size;
+        std::size_t thread_count = (std::min) (chunk_count, thread_num);
+
+        std::vector <boost::optional <Result>> partial_results (chunk_count);
+        std::vector <std::exception_ptr> errors (thread_count);
+
+        // Thread "thread_index" processes chunks thread_index,
+        // thread_index + thread_count, ....
+        auto process = [&] (std::size_t thread_index) {
+            try {
+                for (std::size_t chunk = thread_index; chunk < chunk_count;
+                    chunk += thread_count)
+                {
+                    Iterator chunk_first = first + chunk * chunk_size;
+                    Iterator chunk_last = first
+                        + (std::min) (size, (chunk + 1) * chunk_size);
+                    partial_results [chunk] = reduce_sequential <Result> (
+                        chunk_first, chunk_last, operation);
+                }
+            } catch (...) {
+                errors [thread_index] = std::current_exception();
+            }
+        };
+
+        // The current thread does part of the work too.
+        std::vector <std::thread> threads;
+        {
+            join_threads join (threads);
+            for (std::size_t thread_index = 1; thread_index < thread_count;
+                    ++ thread_index)
+                threads.emplace_back (process, thread_index);
+            process (0);
+        }
+
+        for (std::exception_ptr const & error : errors) {
+            if (error)
+                std::rethrow_exception (error);
+        }
+
+        Result result (std::move (*partial_results.front()));
+        for (std::size_t chunk = 1; chunk != chunk_count; ++ chunk)
+            result = operation (std::move (result),
+                std::move (*partial_results [chunk]));
+        return result;
+    }
+
+} // namespace detail
+
+/**
+Combine all elements of a range with a magma operation.
+For example, <c>reduce (values, math::plus)</c> computes the sum of all
+elements.
+
+If \a Operation is associative on the elements of the range (see
+math::is::associative), and the range is random-access, the range is split into
+chunks of \a chunk_size elements.
+The elements within each chunk are combined from left to right, and the chunks
+are processed in parallel on up to \a thread_num threads.
+A range of at most \a chunk_size elements is therefore combined on the current
+thread, without starting any threads.
+The results of the chunks are then combined from left to right.
+The order of the operands is always kept, so the operation does not need to be
+commutative.
+
+The result is reproducible for a fixed \a chunk_size: it does not depend on the
+number of threads.
+For approximate operations, like addition of floating-point numbers, the result
+can differ between chunk sizes.
+
+If the operation is not associative, or the range is not random-access, the
+elements are combined from left to right on the current thread, and
+\a chunk_size is ignored.
+
+If the operation throws an exception, it is propagated to the caller once all
+threads have finished.
+
+\param range The range with the elements to be combined.
+\param operation The operation, normally an object in namespace math, like
+    math::plus or math::times.
+\param chunk_size The number of elements to combine on one thread before the
+    results are combined.
+\param thread_num The maximum number of threads to use, including the current
+    thread.
+    If this is 0, std::thread::hardware_concurrency() is used.
+\return The result of combining all elements.
+\throw std::invalid_argument if the range is empty, since there is no general
+    way of finding the identity of \a Operation; or if \a chunk_size is 0.
+*/
+template <class Range, class Operation>
+    inline typename detail::reduce_types <Range, Operation>::result_type
+    reduce (Range const & range, Operation const & operation,
+        std::size_t chunk_size = detail::reduce_default_chunk_size,
+        std::size_t thread_num = 0)
+{
+    typedef detail::reduce_types <Range, Operation> types;
+    auto first = std::begin (range);
+    auto last = std::end (range);
+    if (first == last)
+        throw std::invalid_argument ("math::reduce: the range is empty.");
+    if (chunk_size == 0)
+        throw std::invalid_argument ("math::reduce: the chunk size is 0.");
+    return detail::reduce <typename types::result_type> (
+        first, last, operation, chunk_size, thread_num,
+        typename types::chunked());
+}
+
+} // namespace math
+
+#endif // MATH_REDUCE_HPP_INCLUDED
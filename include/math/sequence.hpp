@@ -18,16 +18,20 @@ limitations under the License.
 #define MATH_SEQUENCE_HPP_INCLUDED
 
 #include <vector>
-#include <list>
+#include <algorithm>
 #include <stdexcept>
-#include <algorithm> // for std::reverse.
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <type_traits>
+#include <utility>
 
 #include <iosfwd>
 
 #include <boost/utility/enable_if.hpp>
 #include <boost/mpl/bool.hpp>
 #include <boost/optional.hpp>
-#include <boost/functional/hash_fwd.hpp>
+#include <boost/functional/hash.hpp>
 
 #include "utility/overload_order.hpp"
 #include "utility/disable_if_same.hpp"
@@ -41,12 +45,16 @@ limitations under the License.
 #include "range/equal.hpp"
 #include "range/less_lexicographical.hpp"
 #include "range/hash_range.hpp"
+#include "range/iterator_range.hpp"
 
 #include "rime/if.hpp"
 #include "rime/call_if.hpp"
 #include "rime/assert.hpp"
 
 #include "magma.hpp"
+#include "detail/sequence_storage.hpp"
+#include "detail/common_length.hpp"
+#include "detail/sequence_intern_table.hpp"
 
 namespace math {
 
@@ -62,29 +70,42 @@ suffix (if \a Direction is \ref right).
 \ref divide is only defined from \a Direction, and then only if the divisor is
 a prefix (or suffix) of the dividend.
 
+If \a Direction is \ref either, the sequence can be divided from the left and
+from the right, but \ref plus is not defined, because the longest common
+prefix and the longest common suffix would both be candidates.
+The result of division from either side shares the memory of the dividend, so
+the only cost is comparing the symbols of the divisor.
+This is useful, for example, to remove symbols from both ends of a sequence.
+
 \ref compare implements a strict weak ordering by sorting elements
-lexicographically from \a Direction.
+lexicographically from \a Direction (from the front if \a Direction is
+\ref either).
 \ref choose picks the shortest sequence first, and uses lexicographical order
 from \a Direction as a tie-breaker.
 This makes the sequence a semiring with \ref times and \ref choose in both
 directions, whatever the value of \a Direction
 
+Short sequences are stored inside the object, without allocating memory; see
+detail::sequence_inline_capacity for the exact number of symbols.
+Longer sequences are stored on the heap, and copies share this memory.
+The results of \ref plus and \ref divide share the memory of their operands.
+
 Sequences support Boost.Hash, if \c boost/functional/hash.hpp is included.
 Sequences of different types that compare equal have the same hash value.
 The details of how the hashes are computed (in what direction, for example) are
 not defined, and likely to change in future versions.
 
 \sa math::empty_sequence, math::single_sequence, math::optional_sequence,
-math::sequence_annihilator
+math::sequence_annihilator, math::shared_sequence, math::interned_sequence
 
-\todo Should a bi-directional version be implemented, which would not provide
-the plus operation, but allow division in either direction?
 */
 template <class Symbol, class Direction = left> class sequence;
 template <class Symbol, class Direction = left> class empty_sequence;
 template <class Symbol, class Direction = left> class single_sequence;
 template <class Symbol, class Direction = left> class optional_sequence;
 template <class Symbol, class Direction = left> class sequence_annihilator;
+template <class Symbol, class Direction = left> class shared_sequence;
+template <class Symbol, class Direction = left> class interned_sequence;
 
 template <class Symbol, class Direction> struct sequence_tag;
 
@@ -108,10 +129,18 @@ template <class Symbol, class Direction>
     struct decayed_magma_tag <sequence_annihilator <Symbol, Direction>>
 { typedef sequence_tag <Symbol, Direction> type; };
 
+template <class Symbol, class Direction>
+    struct decayed_magma_tag <shared_sequence <Symbol, Direction>>
+{ typedef sequence_tag <Symbol, Direction> type; };
+
+template <class Symbol, class Direction>
+    struct decayed_magma_tag <interned_sequence <Symbol, Direction>>
+{ typedef sequence_tag <Symbol, Direction> type; };
+
 template <class Symbol, class Direction> class sequence {
 private:
     bool is_annihilator_;
-    std::vector <Symbol> symbols_;
+    detail::sequence_storage <Symbol> symbols_;
 public:
     /**
     Initialise with no symbols.
@@ -129,7 +158,8 @@ public:
     Initialise with a sequence with one element.
     */
     sequence (single_sequence <Symbol, Direction> const & s)
-    : is_annihilator_ (false), symbols_ (1, s.symbol()) {}
+    : is_annihilator_ (false), symbols_()
+    { symbols_.push_back (s.symbol()); }
 
     /**
     Initialise with a sequence with zero or one element.
@@ -149,6 +179,28 @@ public:
     sequence (sequence_annihilator <Symbol, Direction> const &)
     : is_annihilator_ (true) {}
 
+    /**
+    Initialise with a shared_sequence.
+    This concatenates its pieces, if that has not happened yet.
+    */
+    sequence (shared_sequence <Symbol, Direction> const & s)
+    : is_annihilator_ (s.is_annihilator())
+    {
+        if (!is_annihilator_)
+            symbols_ = s.storage();
+    }
+
+    /**
+    Initialise with an interned_sequence.
+    This shares its symbols.
+    */
+    sequence (interned_sequence <Symbol, Direction> const & s)
+    : is_annihilator_ (s.is_annihilator())
+    {
+        if (!is_annihilator_)
+            symbols_ = s.storage();
+    }
+
     /**
     Initialise with a range of symbols.
     */
@@ -162,11 +214,11 @@ public:
     }
 
     /**
-    Initialise with a range of symbols.
-    (Optimised version using the move constructor of std::vector.)
+    Initialise with symbols that are already in place.
+    This is used by operations that compute the symbols of the result directly.
     */
-    template <class Range> explicit sequence (std::vector <Symbol> && range)
-    : is_annihilator_ (false), symbols_ (std::move (range)) {}
+    explicit sequence (detail::sequence_storage <Symbol> && symbols)
+    : is_annihilator_ (false), symbols_ (std::move (symbols)) {}
 
     /**
     Return \c true iff this is an annihilator.
@@ -179,14 +231,25 @@ public:
     */
     bool empty() const {
         assert (!is_annihilator());
-        return range::empty (symbols_);
+        return symbols_.empty();
     }
 
     /**
     Return a range containing the symbols.
     \pre This is not an annihilator.
     */
-    std::vector <Symbol> const & symbols() const {
+    range::iterator_range <Symbol const *> symbols() const {
+        assert (!is_annihilator());
+        return range::iterator_range <Symbol const *> (
+            symbols_.begin(), symbols_.end());
+    }
+
+    /**
+    Return the underlying storage for the symbols.
+    This is for the implementation of operations.
+    \pre This is not an annihilator.
+    */
+    detail::sequence_storage <Symbol> const & storage() const {
         assert (!is_annihilator());
         return symbols_;
     }
@@ -413,6 +476,484 @@ public:
     rime::true_type is_annihilator() const { return rime::true_; }
 };
 
+/**
+Sequence that is represented as a tree of pieces that are shared between
+objects, so that \ref times takes constant time.
+
+Concatenating sequences one symbol at a time, as happens when collecting the
+labels along a path, costs time quadratic in the length of the result with
+math::sequence, since every concatenation copies both operands.
+With this class, concatenation creates a node that refers to its two operands,
+which are shared, not copied.
+
+The symbols are concatenated into one contiguous piece of memory only when they
+are requested, through symbols(), or when the object is converted to
+math::sequence.
+This happens only once: the result is kept, so that copies and objects
+that share the node do not need to do it again.
+This is thread-safe.
+
+This can represent any sequence, and all other classes in the magma can be
+converted to this one implicitly.
+It can also be converted to math::sequence implicitly.
+\ref times returns a shared_sequence if either operand is a shared_sequence.
+The other operations convert it to math::sequence.
+
+\sa math::sequence
+*/
+template <class Symbol, class Direction> class shared_sequence {
+private:
+    typedef detail::sequence_storage <Symbol> storage_type;
+
+    /**
+    A node is either a leaf, which contains symbols, or the concatenation of
+    two nodes.
+    Once a concatenation has been flattened, it holds the symbols too, and it
+    releases its children.
+    Another thread may be flattening a parent of this node at the same time,
+    and reading the children, so they are accessed with std::atomic_load and
+    std::atomic_store.
+    */
+    struct node {
+        std::size_t size;
+        mutable std::shared_ptr <node const> left;
+        mutable std::shared_ptr <node const> right;
+        // For a leaf, the symbols; for a concatenation, the symbols after
+        // flatten() has been called.
+        mutable storage_type symbols;
+        mutable std::once_flag flattened;
+        // Whether "symbols" is complete.
+        mutable std::atomic <bool> has_symbols;
+
+        explicit node (storage_type && leaf_symbols)
+        : size (leaf_symbols.size()), symbols (std::move (leaf_symbols)),
+            has_symbols (true) {}
+
+        node (std::shared_ptr <node const> const & left,
+            std::shared_ptr <node const> const & right)
+        : size (left->size + right->size), left (left), right (right),
+            has_symbols (false) {}
+
+        // Destroying a long chain of nodes recursively would overflow the
+        // stack, so release the children that only this node refers to in a
+        // loop.
+        // No other thread can refer to this node any more, so the children
+        // can be accessed directly.
+        ~node() {
+            if (!left)
+                return;
+            std::vector <std::shared_ptr <node const>> pending;
+            pending.push_back (std::move (left));
+            pending.push_back (std::move (right));
+            while (!pending.empty()) {
+                std::shared_ptr <node const> current = std::move (
+                    pending.back());
+                pending.pop_back();
+                if (current && current.use_count() == 1) {
+                    node & unique = const_cast <node &> (*current);
+                    pending.push_back (std::move (unique.left));
+                    pending.push_back (std::move (unique.right));
+                }
+            }
+        }
+
+        /**
+        If the children of \a current are still there, push them onto
+        \a stack, right first, and return \c true.
+        If \a current has symbols instead, return \c false.
+        */
+        static bool push_children (node const & current,
+            std::vector <std::shared_ptr <node const>> & stack)
+        {
+            if (current.has_symbols.load (std::memory_order_acquire))
+                return false;
+            // The children are released only after has_symbols is set, so if
+            // either is null, the symbols are there.
+            std::shared_ptr <node const> left = std::atomic_load (
+                &current.left);
+            std::shared_ptr <node const> right = std::atomic_load (
+                &current.right);
+            if (!left || !right)
+                return false;
+            stack.push_back (std::move (right));
+            stack.push_back (std::move (left));
+            return true;
+        }
+
+        /**
+        Collect the symbols from left to right, from the highest nodes that
+        have them, and then release the children.
+        */
+        void flatten() const {
+            // The node may outlive any arena that is active on this thread, so
+            // the symbols are allocated on the heap.
+            arena_scope heap (nullptr);
+            storage_type result (size);
+            // The stack holds references, so that the nodes remain alive even
+            // if another thread flattens their parents and releases them.
+            std::vector <std::shared_ptr <node const>> stack;
+            push_children (*this, stack);
+            while (!stack.empty()) {
+                std::shared_ptr <node const> current = std::move (
+                    stack.back());
+                stack.pop_back();
+                if (!push_children (*current, stack))
+                    result.append (current->symbols.begin(),
+                        current->symbols.end());
+            }
+            symbols = std::move (result);
+            has_symbols.store (true, std::memory_order_release);
+            std::atomic_store (&left, std::shared_ptr <node const>());
+            std::atomic_store (&right, std::shared_ptr <node const>());
+        }
+
+        storage_type const & get_symbols() const {
+            if (!has_symbols.load (std::memory_order_acquire))
+                std::call_once (flattened, &node::flatten, this);
+            return symbols;
+        }
+    };
+
+    bool is_annihilator_;
+    // Null for the empty sequence and for the annihilator.
+    std::shared_ptr <node const> root_;
+
+    static std::shared_ptr <node const> make_leaf (storage_type && symbols) {
+        if (symbols.empty())
+            return std::shared_ptr <node const>();
+        return std::make_shared <node> (std::move (symbols));
+    }
+
+    static storage_type const & empty_storage() {
+        static storage_type const empty;
+        return empty;
+    }
+
+    // Concatenate two sequences that are not annihilators.
+    shared_sequence (shared_sequence const & left,
+        shared_sequence const & right)
+    : is_annihilator_ (false),
+        root_ (!left.root_ ? right.root_
+            : !right.root_ ? left.root_
+            : std::make_shared <node> (left.root_, right.root_))
+    { assert (!left.is_annihilator() && !right.is_annihilator()); }
+
+    friend struct operation::times <sequence_tag <Symbol, Direction>>;
+
+public:
+    /**
+    Initialise with no symbols.
+    (Multiplicative identity.)
+    */
+    shared_sequence() : is_annihilator_ (false) {}
+
+    /**
+    Initialise with the empty sequence.
+    */
+    shared_sequence (empty_sequence <Symbol, Direction> const &)
+    : is_annihilator_ (false) {}
+
+    /**
+    Initialise with a sequence with one element.
+    */
+    shared_sequence (single_sequence <Symbol, Direction> const & s)
+    : is_annihilator_ (false), root_ (make_leaf (storage_type (
+        sequence <Symbol, Direction> (s).storage()))) {}
+
+    /**
+    Initialise with a sequence with zero or one element.
+    */
+    shared_sequence (optional_sequence <Symbol, Direction> const & s)
+    : is_annihilator_ (false), root_ (make_leaf (storage_type (
+        sequence <Symbol, Direction> (s).storage()))) {}
+
+    /**
+    Initialise with a sequence.
+    If the symbols are stored on the heap, they are shared, not copied.
+    */
+    shared_sequence (sequence <Symbol, Direction> const & s)
+    : is_annihilator_ (s.is_annihilator()),
+        root_ (s.is_annihilator() ? std::shared_ptr <node const>()
+            : make_leaf (storage_type (s.storage()))) {}
+
+    /**
+    Initialise with an interned_sequence.
+    Its symbols are shared, not copied.
+    */
+    shared_sequence (interned_sequence <Symbol, Direction> const & s)
+    : is_annihilator_ (s.is_annihilator()),
+        root_ (s.is_annihilator() ? std::shared_ptr <node const>()
+            : make_leaf (storage_type (s.storage()))) {}
+
+    /**
+    Initialise as the multiplicative annihilator.
+    (Additive identity.)
+    */
+    shared_sequence (sequence_annihilator <Symbol, Direction> const &)
+    : is_annihilator_ (true) {}
+
+    /**
+    Initialise with a range of symbols.
+    */
+    template <class Range, class Enable = typename
+            boost::enable_if <range::is_range <Range>>::type>
+        explicit shared_sequence (Range && range)
+    : is_annihilator_ (false), root_ (make_leaf (storage_type (
+        sequence <Symbol, Direction> (std::forward <Range> (range))
+            .storage()))) {}
+
+    /**
+    Return \c true iff this is an annihilator.
+    */
+    bool is_annihilator() const { return is_annihilator_; }
+
+    /**
+    Return \c true iff this contains a symbol sequence of zero elements.
+    \pre This is not an annihilator.
+    */
+    bool empty() const {
+        assert (!is_annihilator());
+        return !root_;
+    }
+
+    /**
+    Return the number of symbols.
+    This takes constant time.
+    \pre This is not an annihilator.
+    */
+    std::size_t size() const {
+        assert (!is_annihilator());
+        return root_ ? root_->size : 0;
+    }
+
+    /**
+    Return a range containing the symbols.
+    The first time this is called on a concatenation, the symbols are copied
+    into contiguous memory.
+    \pre This is not an annihilator.
+    */
+    range::iterator_range <Symbol const *> symbols() const {
+        storage_type const & symbols = storage();
+        return range::iterator_range <Symbol const *> (
+            symbols.begin(), symbols.end());
+    }
+
+    /**
+    Return the storage for the symbols, concatenating them first if necessary.
+    This is for the implementation of operations.
+    \pre This is not an annihilator.
+    */
+    storage_type const & storage() const {
+        assert (!is_annihilator());
+        return root_ ? root_->get_symbols() : empty_storage();
+    }
+};
+
+/**
+Sequence of which only one copy is kept for each distinct sequence of symbols,
+so that comparing two of them takes constant time.
+
+All interned_sequence objects with the same symbols, and with any
+\a Direction, refer to the same entry in a table that is shared between
+threads.
+Comparing two interned_sequence objects for equality therefore compares two
+pointers.
+The hash value is computed once, when the symbols are added to the table, and
+is the same as the hash value of a math::sequence with the same symbols.
+This is useful for sequences that are used as keys in large hash tables, for
+example in determinisation.
+An entry is removed from the table when the last interned_sequence that refers
+to it is destructed.
+
+Converting to interned_sequence requires computing the hash value and looking
+up the symbols in the table, so it is explicit, except from empty_sequence and
+sequence_annihilator, which are not stored in the table.
+Converting to math::sequence or to math::shared_sequence is implicit, and
+shares the symbols.
+The operations return the same types as they would for math::sequence.
+To intern their results, convert them explicitly.
+
+\sa math::sequence
+*/
+template <class Symbol, class Direction> class interned_sequence {
+private:
+    typedef detail::sequence_storage <Symbol> storage_type;
+    typedef detail::sequence_intern_table <Symbol> table_type;
+    typedef typename table_type::entry entry_type;
+
+    bool is_annihilator_;
+    // Null for the empty sequence and for the annihilator.
+    entry_type * entry_;
+
+    static std::size_t hash_symbols (
+        Symbol const * first, Symbol const * last)
+    {
+        return range::hash_range (
+            range::iterator_range <Symbol const *> (first, last));
+    }
+
+    static entry_type * intern (storage_type const & symbols) {
+        if (symbols.empty())
+            return nullptr;
+        return table_type::instance().acquire (symbols.begin(), symbols.end(),
+            hash_symbols (symbols.begin(), symbols.end()));
+    }
+
+    static storage_type const & empty_storage() {
+        static storage_type const empty;
+        return empty;
+    }
+
+    void release() {
+        if (entry_)
+            table_type::instance().release (entry_);
+    }
+
+    friend struct operation::equal <sequence_tag <Symbol, Direction>>;
+
+public:
+    /**
+    Initialise with no symbols.
+    (Multiplicative identity.)
+    */
+    interned_sequence() : is_annihilator_ (false), entry_ (nullptr) {}
+
+    /**
+    Initialise with the empty sequence.
+    */
+    interned_sequence (empty_sequence <Symbol, Direction> const &)
+    : is_annihilator_ (false), entry_ (nullptr) {}
+
+    /**
+    Initialise as the multiplicative annihilator.
+    (Additive identity.)
+    */
+    interned_sequence (sequence_annihilator <Symbol, Direction> const &)
+    : is_annihilator_ (true), entry_ (nullptr) {}
+
+    /**
+    Initialise with a sequence with one element.
+    */
+    explicit interned_sequence (
+        single_sequence <Symbol, Direction> const & s)
+    : is_annihilator_ (false),
+        entry_ (intern (sequence <Symbol, Direction> (s).storage())) {}
+
+    /**
+    Initialise with a sequence with zero or one element.
+    */
+    explicit interned_sequence (
+        optional_sequence <Symbol, Direction> const & s)
+    : is_annihilator_ (false),
+        entry_ (intern (sequence <Symbol, Direction> (s).storage())) {}
+
+    /**
+    Initialise with a sequence.
+    */
+    explicit interned_sequence (sequence <Symbol, Direction> const & s)
+    : is_annihilator_ (s.is_annihilator()),
+        entry_ (s.is_annihilator() ? nullptr : intern (s.storage())) {}
+
+    /**
+    Initialise with a shared_sequence.
+    */
+    explicit interned_sequence (shared_sequence <Symbol, Direction> const & s)
+    : is_annihilator_ (s.is_annihilator()),
+        entry_ (s.is_annihilator() ? nullptr : intern (s.storage())) {}
+
+    /**
+    Initialise with a range of symbols.
+    */
+    template <class Range, class Enable = typename
+            boost::enable_if <range::is_range <Range>>::type>
+        explicit interned_sequence (Range && range)
+    : is_annihilator_ (false), entry_ (intern (
+        sequence <Symbol, Direction> (std::forward <Range> (range))
+            .storage())) {}
+
+    interned_sequence (interned_sequence const & that)
+    : is_annihilator_ (that.is_annihilator_), entry_ (that.entry_)
+    {
+        if (entry_)
+            table_type::add_reference (entry_);
+    }
+
+    interned_sequence (interned_sequence && that) noexcept
+    : is_annihilator_ (that.is_annihilator_), entry_ (that.entry_)
+    { that.entry_ = nullptr; }
+
+    ~interned_sequence() { release(); }
+
+    interned_sequence & operator= (interned_sequence const & that) {
+        if (that.entry_)
+            table_type::add_reference (that.entry_);
+        release();
+        is_annihilator_ = that.is_annihilator_;
+        entry_ = that.entry_;
+        return *this;
+    }
+
+    // The entry that this held is released when "that" is destructed.
+    interned_sequence & operator= (interned_sequence && that) noexcept {
+        std::swap (is_annihilator_, that.is_annihilator_);
+        std::swap (entry_, that.entry_);
+        return *this;
+    }
+
+    /**
+    Return \c true iff this is an annihilator.
+    */
+    bool is_annihilator() const { return is_annihilator_; }
+
+    /**
+    Return \c true iff this contains a symbol sequence of zero elements.
+    \pre This is not an annihilator.
+    */
+    bool empty() const {
+        assert (!is_annihilator());
+        return !entry_;
+    }
+
+    /**
+    Return the number of symbols.
+    \pre This is not an annihilator.
+    */
+    std::size_t size() const { return storage().size(); }
+
+    /**
+    Return a range containing the symbols.
+    \pre This is not an annihilator.
+    */
+    range::iterator_range <Symbol const *> symbols() const {
+        storage_type const & symbols = storage();
+        return range::iterator_range <Symbol const *> (
+            symbols.begin(), symbols.end());
+    }
+
+    /**
+    Return the storage for the symbols.
+    This is for the implementation of operations.
+    \pre This is not an annihilator.
+    */
+    storage_type const & storage() const {
+        assert (!is_annihilator());
+        return entry_ ? entry_->symbols() : empty_storage();
+    }
+
+    /**
+    Return the hash value of the symbols, which was computed when they were
+    added to the table.
+    \pre This is not an annihilator.
+    */
+    std::size_t hash() const {
+        assert (!is_annihilator());
+        if (entry_)
+            return entry_->hash();
+        static std::size_t const empty_hash = hash_symbols (nullptr, nullptr);
+        return empty_hash;
+    }
+};
+
 namespace detail {
 
     template <class Type> struct is_sequence_tag : boost::mpl::false_ {};
@@ -434,6 +975,23 @@ namespace operation {
 
     namespace sequence_detail {
 
+        /**
+        Evaluate to \c true iff \a Sequence is a sequence type that operations
+        other than \ref times convert to math::sequence first.
+        */
+        template <class Sequence> struct is_converted_to_sequence
+        : std::false_type {};
+
+        template <class Symbol, class Direction>
+            struct is_converted_to_sequence <
+                shared_sequence <Symbol, Direction>>
+        : std::true_type {};
+
+        template <class Symbol, class Direction>
+            struct is_converted_to_sequence <
+                interned_sequence <Symbol, Direction>>
+        : std::true_type {};
+
         /**
         Return the range direction associated with the direction.
         <c>range_direction<left>::type</c> is <c>::direction::front</c>.
@@ -445,6 +1003,163 @@ namespace operation {
         { typedef ::direction::front type; };
         template <> struct range_direction <right>
         { typedef ::direction::back type; };
+        // Sequences that can be divided from either side are ordered from the
+        // front.
+        template <> struct range_direction <either>
+        { typedef ::direction::front type; };
+
+        /**
+        Operations on the storage of sequences that work from the start (for
+        \ref left) or from the end (for \ref right).
+        The results of take() and drop() share the symbols on the heap.
+        */
+        template <class Direction> struct from_direction;
+
+        template <> struct from_direction <left> {
+            /**
+            Return the number of symbols that two sequences have in common at
+            the start.
+            */
+            template <class Symbol> static std::size_t common_length (
+                detail::sequence_storage <Symbol> const & symbols1,
+                detail::sequence_storage <Symbol> const & symbols2)
+            {
+                return detail::common_prefix_length (
+                    symbols1.begin(), symbols2.begin(),
+                    (std::min) (symbols1.size(), symbols2.size()));
+            }
+
+            /// Return the first \a length symbols.
+            template <class Symbol> static detail::sequence_storage <Symbol>
+                take (detail::sequence_storage <Symbol> const & symbols,
+                    std::size_t length)
+            { return symbols.slice (0, length); }
+
+            /// Return the symbols without the first \a length.
+            template <class Symbol> static detail::sequence_storage <Symbol>
+                drop (detail::sequence_storage <Symbol> const & symbols,
+                    std::size_t length)
+            { return symbols.slice (length, symbols.size() - length); }
+        };
+
+        template <> struct from_direction <right> {
+            /**
+            Return the number of symbols that two sequences have in common at
+            the end.
+            */
+            template <class Symbol> static std::size_t common_length (
+                detail::sequence_storage <Symbol> const & symbols1,
+                detail::sequence_storage <Symbol> const & symbols2)
+            {
+                return detail::common_suffix_length (
+                    symbols1.end(), symbols2.end(),
+                    (std::min) (symbols1.size(), symbols2.size()));
+            }
+
+            /// Return the last \a length symbols.
+            template <class Symbol> static detail::sequence_storage <Symbol>
+                take (detail::sequence_storage <Symbol> const & symbols,
+                    std::size_t length)
+            { return symbols.slice (symbols.size() - length, length); }
+
+            /// Return the symbols without the last \a length.
+            template <class Symbol> static detail::sequence_storage <Symbol>
+                drop (detail::sequence_storage <Symbol> const & symbols,
+                    std::size_t length)
+            { return symbols.slice (0, symbols.size() - length); }
+        };
+
+        /*
+        Count and append the symbols of operands of times, so that the
+        result can be written into storage of the right size directly.
+        The annihilator must be dealt with before these are called.
+        */
+        template <class Symbol, class Direction> inline std::size_t
+            symbol_count (sequence_annihilator <Symbol, Direction> const &)
+        { assert (false); return 0; }
+
+        template <class Symbol, class Direction> inline std::size_t
+            symbol_count (empty_sequence <Symbol, Direction> const &)
+        { return 0; }
+
+        template <class Symbol, class Direction> inline std::size_t
+            symbol_count (single_sequence <Symbol, Direction> const &)
+        { return 1; }
+
+        template <class Symbol, class Direction> inline std::size_t
+            symbol_count (optional_sequence <Symbol, Direction> const & s)
+        { return s.empty() ? 0 : 1; }
+
+        template <class Symbol, class Direction> inline std::size_t
+            symbol_count (sequence <Symbol, Direction> const & s)
+        { return s.storage().size(); }
+
+        template <class Symbol, class Direction> inline std::size_t
+            symbol_count (interned_sequence <Symbol, Direction> const & s)
+        { return s.storage().size(); }
+
+        template <class Symbol, class Direction> inline void append_symbols (
+            detail::sequence_storage <Symbol> &,
+            sequence_annihilator <Symbol, Direction> const &)
+        { assert (false); }
+
+        template <class Symbol, class Direction> inline void append_symbols (
+            detail::sequence_storage <Symbol> &,
+            empty_sequence <Symbol, Direction> const &)
+        {}
+
+        template <class Symbol, class Direction> inline void append_symbols (
+            detail::sequence_storage <Symbol> & symbols,
+            single_sequence <Symbol, Direction> const & s)
+        { symbols.push_back (s.symbol()); }
+
+        template <class Symbol, class Direction> inline void append_symbols (
+            detail::sequence_storage <Symbol> & symbols,
+            optional_sequence <Symbol, Direction> const & s)
+        {
+            if (!s.empty())
+                symbols.push_back (s.symbol().get());
+        }
+
+        template <class Symbol, class Direction> inline void append_symbols (
+            detail::sequence_storage <Symbol> & symbols,
+            sequence <Symbol, Direction> const & s)
+        { symbols.append (s.storage().begin(), s.storage().end()); }
+
+        template <class Symbol, class Direction> inline void append_symbols (
+            detail::sequence_storage <Symbol> & symbols,
+            interned_sequence <Symbol, Direction> const & s)
+        { symbols.append (s.storage().begin(), s.storage().end()); }
+
+        /**
+        Evaluate to \c true iff any of \a Sequences is a shared_sequence.
+        */
+        template <class ... Sequences> struct any_shared
+        : std::false_type {};
+
+        template <class Sequence, class ... Sequences>
+            struct any_shared <Sequence, Sequences ...>
+        : any_shared <Sequences ...> {};
+
+        template <class Symbol, class Direction, class ... Sequences>
+            struct any_shared <shared_sequence <Symbol, Direction>,
+                Sequences ...>
+        : std::true_type {};
+
+        /**
+        Evaluate to \c true iff sequences with direction \a SequenceDirection
+        can be divided from \a Direction.
+        Sequences with direction \ref left or \ref right can only be divided
+        from that direction; sequences with direction \ref either can be
+        divided from \ref left and from \ref right, but the two are not the
+        same, so not from \ref either.
+        */
+        template <class SequenceDirection, class Direction>
+            struct can_divide_from
+        : std::integral_constant <bool,
+            !std::is_same <Direction, either>::value
+            && (std::is_same <SequenceDirection, Direction>::value
+                || std::is_same <SequenceDirection, either>::value)> {};
 
     } // namespace sequence_detail
 
@@ -473,12 +1188,22 @@ namespace operation {
                 sequence1, sequence2));
         };
 
+        typedef interned_sequence <Symbol, Direction> interned_type;
+
     public:
         template <class Sequence1, class Sequence2> auto operator () (
             Sequence1 const & sequence1, Sequence2 const & sequence2) const
         RETURNS (rime::call_if (sequence1.is_annihilator(),
             when_first_annihilator(), when_first_not_annihilator(),
             sequence1, sequence2));
+
+        // Interned sequences are equal iff they refer to the same entry.
+        bool operator() (interned_type const & sequence1,
+            interned_type const & sequence2) const
+        {
+            return sequence1.is_annihilator_ == sequence2.is_annihilator_
+                && sequence1.entry_ == sequence2.entry_;
+        }
     };
 
     template <class Symbol, class Direction>
@@ -848,9 +1573,6 @@ namespace operation {
     private:
         typedef sequence_annihilator <Symbol, Direction> annihilator_type;
         typedef empty_sequence <Symbol, Direction> empty_type;
-        typedef single_sequence <Symbol, Direction> single_type;
-        typedef optional_sequence <Symbol, Direction> optional_type;
-        typedef sequence <Symbol, Direction> sequence_type;
 
         struct implementation {
             // Annihilator: annihilates.
@@ -886,39 +1608,48 @@ namespace operation {
             RETURNS (left);
 
             // Non-empty: both operands could be three types.
+            // The length of the result is known beforehand, so the symbols are
+            // written into storage of the right size directly.
+            typedef detail::sequence_storage <Symbol> storage_type;
 
-            void append_symbols (
-                std::vector <Symbol> & symbols, single_type const & s) const
-            { symbols.push_back (s.symbol()); }
+            // At least one shared_sequence: share both operands.
+            // This only matches the exact types, not types that convert to
+            // shared_sequence, so that it does not compete with the general
+            // overload below.
+            typedef shared_sequence <Symbol, Direction> shared_type;
 
-            void append_symbols (
-                std::vector <Symbol> & symbols, optional_type const & s) const
-            {
-                if (!s.empty())
-                    symbols.push_back (s.symbol().get());
-            }
-
-            void append_symbols (
-                std::vector <Symbol> & symbols, sequence_type const & s) const
+            template <class Sequence1, class Sequence2>
+                typename boost::enable_if_c <
+                    std::is_same <Sequence1, shared_type>::value
+                    || std::is_same <Sequence2, shared_type>::value,
+                    shared_type>::type
+                operator() (
+                    Sequence1 const & sequence1, Sequence2 const & sequence2,
+                    utility::overload_order <3> *) const
             {
-                auto && s_symbols = s.symbols();
-                symbols.insert (symbols.end(),
-                    s_symbols.begin(), s_symbols.end());
+                if (sequence1.is_annihilator())
+                    return shared_type (sequence1);
+                if (sequence2.is_annihilator())
+                    return shared_type (sequence2);
+                return shared_type (
+                    shared_type (sequence1), shared_type (sequence2));
             }
 
             template <class Sequence1, class Sequence2>
                 sequence <Symbol, Direction> operator() (
                     Sequence1 const & sequence1, Sequence2 const & sequence2,
-                    utility::overload_order <3> *) const
+                    utility::overload_order <4> *) const
             {
                 if (sequence1.is_annihilator())
                     return sequence1;
                 if (sequence2.is_annihilator())
                     return sequence2;
 
-                std::vector <Symbol> concatenation;
-                append_symbols (concatenation, sequence1);
-                append_symbols (concatenation, sequence2);
+                storage_type concatenation (
+                    sequence_detail::symbol_count (sequence1)
+                    + sequence_detail::symbol_count (sequence2));
+                sequence_detail::append_symbols (concatenation, sequence1);
+                sequence_detail::append_symbols (concatenation, sequence2);
                 return sequence <Symbol, Direction> (std::move (concatenation));
             }
         };
@@ -936,6 +1667,77 @@ namespace operation {
         */
     };
 
+    /**
+    Concatenate more than two sequences.
+    Unless one of the operands is a shared_sequence, the result is a
+    math::sequence, and the symbols are copied only once, into storage of the
+    right size.
+    If any operand is the annihilator, it is returned without looking at the
+    symbols.
+    If one of the operands is a shared_sequence, the operands are concatenated
+    from left to right, which shares them.
+    */
+    template <class Symbol, class Direction>
+        struct n_ary_times <sequence_tag <Symbol, Direction>>
+    {
+    private:
+        typedef sequence <Symbol, Direction> sequence_type;
+        typedef detail::sequence_storage <Symbol> storage_type;
+
+        static bool any_annihilator() { return false; }
+
+        template <class Sequence, class ... Sequences>
+            static bool any_annihilator (
+                Sequence const & first, Sequences const & ... rest)
+        { return first.is_annihilator() || any_annihilator (rest ...); }
+
+        static std::size_t symbol_count() { return 0; }
+
+        template <class Sequence, class ... Sequences>
+            static std::size_t symbol_count (
+                Sequence const & first, Sequences const & ... rest)
+        {
+            return sequence_detail::symbol_count (first)
+                + symbol_count (rest ...);
+        }
+
+        static void append_symbols (storage_type &) {}
+
+        template <class Sequence, class ... Sequences>
+            static void append_symbols (storage_type & symbols,
+                Sequence const & first, Sequences const & ... rest)
+        {
+            sequence_detail::append_symbols (symbols, first);
+            append_symbols (symbols, rest ...);
+        }
+
+    public:
+        template <class ... Sequences>
+            typename boost::disable_if <
+                sequence_detail::any_shared <Sequences ...>,
+                sequence_type>::type
+            operator() (Sequences const & ... sequences) const
+        {
+            if (any_annihilator (sequences ...))
+                return sequence_annihilator <Symbol, Direction>();
+            storage_type concatenation (symbol_count (sequences ...));
+            append_symbols (concatenation, sequences ...);
+            return sequence_type (std::move (concatenation));
+        }
+
+        template <class ... Sequences>
+            typename boost::lazy_enable_if <
+                sequence_detail::any_shared <Sequences ...>,
+                detail::left_to_right_result <
+                    times <sequence_tag <Symbol, Direction>>,
+                    Sequences const & ...>>::type
+            operator() (Sequences const & ... sequences) const
+        {
+            return times_left_to_right <sequence_tag <Symbol, Direction>>() (
+                sequences ...);
+        }
+    };
+
     /**
     Addition for left sequences: find the longest common prefix.
     */
@@ -974,42 +1776,25 @@ namespace operation {
                 utility::overload_order <4> *) const
             RETURNS (empty);
 
-            // Two sequences: different implementation for left and right.
-            /*
-            \todo This should really be one implementation for left and right
-            sequences.
-            This is easy (take the implementation for the right sequence,and
-            s/range::back/direction/), except for dealing with "push_back".
-            This requires range::subrange.
-            */
-            sequence <Symbol, left> operator() (
-                sequence <Symbol, left> const & sequence1,
-                sequence <Symbol, left> const & sequence2,
-                utility::overload_order <5> * pick) const
-            {
-                // Annihalator is the additive identity.
-                if (sequence1.is_annihilator())
-                    return sequence2;
-                if (sequence2.is_annihilator())
-                    return sequence1;
-
-                // This should be replaced by something with range::subrange.
-                std::vector <Symbol> longest_common_prefix;
-                auto symbols1 = range::view (sequence1.symbols());
-                auto symbols2 = range::view (sequence2.symbols());
-                while (!range::empty (symbols1) && !range::empty (symbols2)
-                    && range::first (symbols1) == range::first (symbols2))
-                {
-                    longest_common_prefix.push_back (range::first (symbols1));
-                    symbols1 = range::drop (symbols1);
-                    symbols2 = range::drop (symbols2);
-                }
-                return sequence <Symbol, left> (longest_common_prefix);
-            }
+            // shared_sequence or interned_sequence: compute the result on
+            // sequence.
+            template <class Sequence1, class Sequence2>
+                typename boost::enable_if_c <
+                    sequence_detail::is_converted_to_sequence <Sequence1>::value
+                    || sequence_detail::is_converted_to_sequence <Sequence2>
+                        ::value,
+                    sequence_type>::type
+                operator() (
+                    Sequence1 const & sequence1, Sequence2 const & sequence2,
+                    utility::overload_order <5> * pick) const
+            { return (*this) (sequence_type (sequence1),
+                sequence_type (sequence2), pick); }
 
-            sequence <Symbol, right> operator() (
-                sequence <Symbol, right> const & sequence1,
-                sequence <Symbol, right> const & sequence2,
+            // Two sequences: the longest common prefix (or suffix) is a slice
+            // of the first sequence, which shares its symbols.
+            sequence_type operator() (
+                sequence_type const & sequence1,
+                sequence_type const & sequence2,
                 utility::overload_order <5> * pick) const
             {
                 // Annihalator is the additive identity.
@@ -1018,20 +1803,13 @@ namespace operation {
                 if (sequence2.is_annihilator())
                     return sequence1;
 
-                std::list <Symbol> longest_common_prefix;
-                auto symbols1 = range::view (sequence1.symbols(), range::back);
-                auto symbols2 = range::view (sequence2.symbols(), range::back);
-                while (!range::empty (symbols1, range::back)
-                    && !range::empty (symbols2, range::back)
-                    && range::first (symbols1, range::back)
-                        == range::first (symbols2, range::back))
-                {
-                    longest_common_prefix.push_front (
-                        range::first (symbols1, range::back));
-                    symbols1 = range::drop (symbols1, range::back);
-                    symbols2 = range::drop (symbols2, range::back);
-                }
-                return sequence <Symbol, right> (longest_common_prefix);
+                typedef sequence_detail::from_direction <Direction> from;
+                auto const & symbols1 = sequence1.storage();
+                std::size_t length = from::common_length (
+                    symbols1, sequence2.storage());
+                if (length == symbols1.size())
+                    return sequence1;
+                return sequence_type (from::take (symbols1, length));
             }
 
             // At least one of the arguments has zero or one, or one elements.
@@ -1050,7 +1828,12 @@ namespace operation {
             { return range::first (s.symbols(), range::back); }
 
             template <class Sequence1, class Sequence2>
-                optional_type operator() (
+                typename boost::disable_if_c <
+                    sequence_detail::is_converted_to_sequence <Sequence1>::value
+                    || sequence_detail::is_converted_to_sequence <Sequence2>
+                        ::value,
+                    optional_type>::type
+                operator() (
                     Sequence1 const & sequence1, Sequence2 const & sequence2,
                     utility::overload_order <5> * pick) const
             {
@@ -1085,6 +1868,10 @@ namespace operation {
         */
     };
 
+    // Sequences that can be divided from either side have no plus.
+    template <class Symbol> struct plus <sequence_tag <Symbol, either>>
+    : unimplemented {};
+
     // The direction matches the direction of the sequence:
     // left and right sequences are left and right semirings over times and
     // plus.
@@ -1093,19 +1880,30 @@ namespace operation {
         callable::times, callable::plus>
     : rime::true_type {};
 
+    template <class Symbol> struct is_semiring <
+        sequence_tag <Symbol, either>, either,
+        callable::times, callable::plus>
+    : rime::false_type {};
+
     /**
-    The prefix of the dividend must be equal to the divisor.
-    \return The dividend without the prefix.
+    The prefix (for \ref left) or suffix (for \ref right) of the dividend must
+    be equal to the divisor.
+    Sequences with direction \ref either can be divided from both sides.
+    \return The dividend without the prefix or suffix.
     */
-    template <class Symbol, class Direction>
-        struct divide <sequence_tag <Symbol, Direction>, Direction>
+    template <class Symbol, class SequenceDirection, class Direction>
+        struct divide <sequence_tag <Symbol, SequenceDirection>, Direction,
+            typename boost::enable_if <sequence_detail::can_divide_from <
+                SequenceDirection, Direction>>::type>
     : throw_if_undefined
     {
-        typedef sequence <Symbol, Direction> sequence_type;
-        typedef empty_sequence <Symbol, Direction> empty_sequence_type;
-        typedef single_sequence <Symbol, Direction> single_sequence_type;
-        typedef optional_sequence <Symbol, Direction> optional_sequence_type;
-        typedef sequence_annihilator <Symbol, Direction>
+        typedef sequence <Symbol, SequenceDirection> sequence_type;
+        typedef empty_sequence <Symbol, SequenceDirection> empty_sequence_type;
+        typedef single_sequence <Symbol, SequenceDirection>
+            single_sequence_type;
+        typedef optional_sequence <Symbol, SequenceDirection>
+            optional_sequence_type;
+        typedef sequence_annihilator <Symbol, SequenceDirection>
             sequence_annihilator_type;
 
         struct implementation {
@@ -1126,22 +1924,19 @@ namespace operation {
                 } else if (divisor.is_annihilator())
                     throw divide_by_zero();
 
-                // Start at the front of the sequence for a left division, and
-                // at the back for a right division.
-                auto start = typename
-                    sequence_detail::range_direction <Direction>::type();
-                auto divisor_symbols = range::view (divisor.symbols(), start);
-                auto dividend_symbols = range::view (dividend.symbols(), start);
-                while (!range::empty (divisor_symbols, start)) {
-                    if (range::empty (dividend_symbols, start))
-                        throw operation_undefined();
-                    if (range::first (dividend_symbols, start)
-                            != range::first (divisor_symbols, start))
-                        throw operation_undefined();
-                    divisor_symbols = range::drop (divisor_symbols, start);
-                    dividend_symbols = range::drop (dividend_symbols, start);
-                }
-                return sequence_type (dividend_symbols);
+                // Compare from the front of the sequence for a left division,
+                // and from the back for a right division.
+                typedef sequence_detail::from_direction <Direction> from;
+                auto const & dividend_symbols = dividend.storage();
+                auto const & divisor_symbols = divisor.storage();
+                if (from::common_length (dividend_symbols, divisor_symbols)
+                        != divisor_symbols.size())
+                    throw operation_undefined();
+                if (divisor_symbols.empty())
+                    return dividend;
+                // The result shares the symbols of the dividend.
+                return sequence_type (
+                    from::drop (dividend_symbols, divisor_symbols.size()));
             }
 
             /* Specialisations. */
@@ -1193,13 +1988,10 @@ namespace operation {
 
             /* 4. Combinations of single, optional, and general sequence. */
 
-            Symbol const & first_symbol (sequence <Symbol, left> const & s)
-                const
-            { return range::first (s.symbols()); }
-
-            Symbol const & first_symbol (sequence <Symbol, right> const & s)
-                const
-            { return range::first (s.symbols(), range::back); }
+            Symbol const & first_symbol (sequence_type const & s) const {
+                return range::first (s.symbols(), typename
+                    sequence_detail::range_direction <Direction>::type());
+            }
 
             empty_sequence_type operator() (
                 single_sequence_type const & dividend,
@@ -1285,14 +2077,11 @@ namespace operation {
                 throw operation_undefined();
             }
 
-            // Negotiate between std::vector and the Range library.
-            std::vector <Symbol> drop_copy (
-                std::vector <Symbol> const & symbols) const
-            {
-                auto result_symbols_source = range::drop (symbols, typename
-                    sequence_detail::range_direction <Direction>::type());
-                return std::vector <Symbol> (
-                    result_symbols_source.begin(), result_symbols_source.end());
+            // Return the sequence without its first symbol (from Direction).
+            // The result shares the symbols of the dividend.
+            sequence_type drop_first (sequence_type const & s) const {
+                return sequence_type (sequence_detail::from_direction <
+                    Direction>::drop (s.storage(), 1));
             }
 
             // Divisor is a single_sequence or an optional_sequence.
@@ -1309,7 +2098,7 @@ namespace operation {
                 if (first_symbol (dividend) != divisor.symbol())
                     throw operation_undefined();
 
-                return sequence_type (drop_copy (dividend.symbols()));
+                return drop_first (dividend);
             }
 
             sequence_type operator() (
@@ -1325,7 +2114,7 @@ namespace operation {
                 if (first_symbol (dividend) != divisor.symbol().get())
                     throw operation_undefined();
 
-                return sequence_type (drop_copy (dividend.symbols()));
+                return drop_first (dividend);
             }
         };
 
@@ -1346,12 +2135,24 @@ namespace operation {
             if (s.is_annihilator())
                 return sequence_annihilator <Symbol, other_direction>();
             else {
-                std::vector <Symbol> symbols = s.symbols();
-                std::reverse (symbols.begin(), symbols.end());
-                return sequence <Symbol, other_direction> (std::move (symbols));
+                auto const & symbols = s.storage();
+                detail::sequence_storage <Symbol> reversed (symbols.size());
+                for (Symbol const * current = symbols.end();
+                        current != symbols.begin();)
+                    reversed.push_back (*-- current);
+                return sequence <Symbol, other_direction> (std::move (reversed));
             }
         }
 
+        // This only matches shared_sequence and interned_sequence exactly, so
+        // that types that convert to both sequence and shared_sequence are not
+        // ambiguous.
+        template <class Sequence> typename boost::enable_if <
+                sequence_detail::is_converted_to_sequence <Sequence>,
+                sequence <Symbol, other_direction>>::type
+            operator() (Sequence const & s) const
+        { return (*this) (sequence <Symbol, Direction> (s)); }
+
         empty_sequence <Symbol, other_direction> operator() (
             empty_sequence <Symbol, Direction> const & s) const
         { return empty_sequence <Symbol, other_direction>(); }
@@ -1382,6 +2183,12 @@ namespace operation {
             }
         }
 
+        template <class Stream, class Sequence>
+            typename boost::enable_if <
+                sequence_detail::is_converted_to_sequence <Sequence>>::type
+            operator() (Stream & stream, Sequence const & s) const
+        { (*this) (stream, sequence <Symbol, Direction> (s)); }
+
         template <class Stream>
             void operator() (Stream & stream,
                 empty_sequence <Symbol, Direction> const &) const
@@ -1413,6 +2220,23 @@ namespace operation {
             Sequence1, Sequence2>
     { typedef sequence <Symbol, Direction> type; };
 
+    // Mixing shared_sequence with anything: shared_sequence.
+    template <class Symbol, class Direction>
+        struct unify_type <sequence_tag <Symbol, Direction>,
+            shared_sequence <Symbol, Direction>,
+            shared_sequence <Symbol, Direction>>
+    { typedef shared_sequence <Symbol, Direction> type; };
+
+    template <class Symbol, class Direction, class Sequence>
+        struct unify_type <sequence_tag <Symbol, Direction>,
+            shared_sequence <Symbol, Direction>, Sequence>
+    { typedef shared_sequence <Symbol, Direction> type; };
+
+    template <class Symbol, class Direction, class Sequence>
+        struct unify_type <sequence_tag <Symbol, Direction>,
+            Sequence, shared_sequence <Symbol, Direction>>
+    { typedef shared_sequence <Symbol, Direction> type; };
+
     // Mixing empty/single sequences.
     template <class Symbol, class Direction>
         struct unify_type <sequence_tag <Symbol, Direction>,
@@ -1468,6 +2292,17 @@ namespace sequence_detail {
     static std::size_t constexpr annihilator_hash =
         std::size_t (0x84c8fa43d5283350 & std::size_t (-1));
 
+    // Compute the hash value of symbols between two pointers in the same way
+    // as for the other sequence types.
+    struct hash_symbols {
+        template <class Symbol> std::size_t operator() (
+            Symbol const * first, Symbol const * last) const
+        {
+            return range::hash_range (
+                range::iterator_range <Symbol const *> (first, last));
+        }
+    };
+
 } // sequence_detail
 
 template <class Symbol, class Direction> inline
@@ -1475,13 +2310,34 @@ template <class Symbol, class Direction> inline
         sequence_annihilator <Symbol, Direction> const & s)
 { return sequence_detail::annihilator_hash; }
 
+// For sequences on the heap, the hash value is kept with the symbols, so that
+// it is computed only once.
 template <class Symbol, class Direction> inline
     std::size_t hash_value (sequence <Symbol, Direction> const & s)
 {
     if (s.is_annihilator())
         return sequence_detail::annihilator_hash;
     else
-        return range::hash_range (s.symbols());
+        return s.storage().hash (sequence_detail::hash_symbols());
+}
+
+template <class Symbol, class Direction> inline
+    std::size_t hash_value (shared_sequence <Symbol, Direction> const & s)
+{
+    if (s.is_annihilator())
+        return sequence_detail::annihilator_hash;
+    else
+        return s.storage().hash (sequence_detail::hash_symbols());
+}
+
+// The hash value of an interned_sequence is computed only once.
+template <class Symbol, class Direction> inline
+    std::size_t hash_value (interned_sequence <Symbol, Direction> const & s)
+{
+    if (s.is_annihilator())
+        return sequence_detail::annihilator_hash;
+    else
+        return s.hash();
 }
 
 template <class Symbol, class Direction> inline
@@ -0,0 +1,100 @@
+/*
+Copyright 2026 Rogier van Dalen.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+/** \file
+Define the overload of math::reduce that concatenates a range of sequences with
+math::times, copying the symbols only once.
+This is in a separate header so that sequence.hpp does not depend on the
+threading in reduce.hpp.
+*/
+
+#ifndef MATH_SEQUENCE_REDUCE_HPP_INCLUDED
+#define MATH_SEQUENCE_REDUCE_HPP_INCLUDED
+
+#include <cstddef>
+#include <iterator>
+#include <type_traits>
+#include <utility>
+
+#include "sequence.hpp"
+#include "reduce.hpp"
+
+namespace math {
+
+namespace sequence_detail {
+
+    /**
+    The type that reduce with math::times returns for a range of \a Sequence,
+    if it concatenates them all at once.
+    shared_sequence is left out, since concatenating it takes constant time.
+    */
+    template <class Sequence,
+            class MagmaTag = typename magma_tag <Sequence>::type>
+        struct concatenation {};
+
+    template <class Sequence, class Symbol, class Direction>
+        struct concatenation <Sequence, sequence_tag <Symbol, Direction>>
+    {
+        typedef sequence <Symbol, Direction> type;
+        typedef sequence_annihilator <Symbol, Direction> annihilator_type;
+        typedef detail::sequence_storage <Symbol> storage_type;
+    };
+
+    template <class Symbol, class Direction>
+        struct concatenation <shared_sequence <Symbol, Direction>,
+            sequence_tag <Symbol, Direction>>
+    {};
+
+    template <class Range> struct range_concatenation
+    : concatenation <typename std::decay <
+        decltype (*std::begin (std::declval <Range const &>()))>::type> {};
+
+} // namespace sequence_detail
+
+/**
+Concatenate all sequences in a range.
+This is an overload of math::reduce for math::times.
+It first computes the length of the result, and then copies the symbols
+into storage of that size, so that, unlike concatenating the sequences one by
+one, it takes time linear in the length of the result.
+If any of the sequences is the annihilator, the annihilator is returned before
+any memory is allocated.
+The range is traversed twice; the chunk size and the number of threads are
+ignored.
+Unlike the general version, this returns an empty sequence if the range is
+empty.
+*/
+template <class Range> inline
+    typename sequence_detail::range_concatenation <Range>::type
+    reduce (Range const & range, callable::times const &,
+        std::size_t = detail::reduce_default_chunk_size, std::size_t = 0)
+{
+    typedef sequence_detail::range_concatenation <Range> types;
+    std::size_t size = 0;
+    for (auto const & s : range) {
+        if (s.is_annihilator())
+            return typename types::annihilator_type();
+        size += operation::sequence_detail::symbol_count (s);
+    }
+    typename types::storage_type symbols (size);
+    for (auto const & s : range)
+        operation::sequence_detail::append_symbols (symbols, s);
+    return typename types::type (std::move (symbols));
+}
+
+} // namespace math
+
+#endif // MATH_SEQUENCE_REDUCE_HPP_INCLUDED
@@ -24,8 +24,11 @@ compiling takes a lot less memory and time.
 #define MATH_TEST_MATH_TEST_SEQUENCE_TESTS_FAST_HPP_INCLUDED
 
 #include "math/sequence.hpp"
+#include "math/sequence_reduce.hpp"
 
 #include <string>
+#include <type_traits>
+#include <vector>
 
 #include <boost/mpl/assert.hpp>
 
@@ -739,6 +742,72 @@ template <class Direction> void test_times() {
     check (abc, abc, sequence (std::string ("abcabc")));
 }
 
+/**
+Test times with more than two operands, and reduce with times.
+*/
+template <class Direction> void test_times_many() {
+    typedef math::sequence <char, Direction> sequence;
+    typedef math::empty_sequence <char, Direction> empty_sequence;
+    typedef math::single_sequence <char, Direction> single_sequence;
+    typedef math::optional_sequence <char, Direction> optional_sequence;
+    typedef math::sequence_annihilator <char, Direction> sequence_annihilator;
+    typedef math::shared_sequence <char, Direction> shared_sequence;
+
+    empty_sequence empty;
+    single_sequence a ('a');
+    optional_sequence b ('b');
+    optional_sequence no_symbol;
+    sequence cde (std::string ("cde"));
+    sequence long_sequence (std::string (50, 'x'));
+    sequence_annihilator annihilator;
+
+    BOOST_MPL_ASSERT ((std::is_same <
+        decltype (math::times (a, b, cde)), sequence>));
+    BOOST_CHECK (math::times (a, b, cde) == sequence (std::string ("abcde")));
+    BOOST_CHECK (math::times (a, empty, no_symbol, cde, b)
+        == sequence (std::string ("acdeb")));
+    BOOST_CHECK (math::times (cde, long_sequence, a)
+        == sequence ("cde" + std::string (50, 'x') + "a"));
+    BOOST_CHECK (math::times (empty, empty, empty) == empty);
+
+    BOOST_CHECK (math::times (a, annihilator, cde) == annihilator);
+    BOOST_CHECK (math::times (a, cde, sequence (annihilator)) == annihilator);
+
+    // The result is the same as from binary times.
+    BOOST_CHECK (math::times (long_sequence, cde, long_sequence, a)
+        == math::times (math::times (math::times (long_sequence, cde),
+            long_sequence), a));
+
+    // With a shared_sequence, the result is a shared_sequence.
+    BOOST_MPL_ASSERT ((std::is_same <
+        decltype (math::times (a, shared_sequence (cde), cde)),
+        shared_sequence>));
+    BOOST_CHECK (math::times (a, shared_sequence (cde), cde)
+        == sequence (std::string ("acdecde")));
+
+    // Range.
+    std::vector <sequence> sequences;
+    std::string expected;
+    for (int i = 0; i != 100; ++ i) {
+        std::string symbols (i % 4, char ('a' + i % 26));
+        sequences.push_back (sequence (symbols));
+        expected += symbols;
+    }
+    BOOST_MPL_ASSERT ((std::is_same <
+        decltype (math::reduce (sequences, math::times)), sequence>));
+    BOOST_CHECK (math::reduce (sequences, math::times)
+        == sequence (expected));
+    BOOST_CHECK (math::reduce (std::vector <sequence>(), math::times)
+        == sequence());
+
+    sequences [50] = annihilator;
+    BOOST_CHECK (math::reduce (sequences, math::times) == annihilator);
+
+    std::vector <single_sequence> singles (3, a);
+    BOOST_CHECK (math::reduce (singles, math::times)
+        == sequence (std::string ("aaa")));
+}
+
 /**
 Test basic properties of plus.
 This is supposed to compute the longest common prefix/suffix, from Direction.
@@ -19,10 +19,16 @@ limitations under the License.
 
 #include "math/alphabet.hpp"
 
+#include <algorithm>
+#include <atomic>
+#include <memory>
 #include <string>
+#include <thread>
+#include <vector>
 
 #include <boost/mpl/assert.hpp>
 #include <boost/functional/hash.hpp>
+#include <boost/utility/string_ref.hpp>
 
 #define CHECK_CONSTANT(expression) \
     BOOST_MPL_ASSERT ((rime::equal_constant <decltype (expression), \
@@ -519,4 +525,265 @@ BOOST_AUTO_TEST_CASE (test_math_alphabet_visit) {
     }
 }
 
+/**
+Check an alphabet with many normal symbols.
+With hashed_symbol_mapping, this causes the hash table to grow a number of
+times.
+*/
+template <class SymbolMapping> void check_many_symbols() {
+    typedef math::alphabet <std::string, word, 0xFFFFFF7F, meta::vector<>,
+        0x80, SymbolMapping> alphabet_type;
+    typedef typename alphabet_type::dense_symbol_type dense_symbol_type;
+    alphabet_type alphabet;
+    auto alphabet2 = math::add_special_symbol <empty> (alphabet);
+
+    std::vector <std::string> words;
+    for (int i = 0; i != 10000; ++ i)
+        words.push_back ("word" + std::to_string ((i * 7919) % 10007));
+
+    for (std::size_t i = 0; i != words.size(); ++ i) {
+        BOOST_CHECK_EQUAL (alphabet.add_symbol (words [i]).id(), int (i));
+        // Adding a symbol again returns the same dense symbol.
+        BOOST_CHECK_EQUAL (alphabet.add_symbol (words [i / 2]).id(),
+            int (i / 2));
+    }
+
+    for (std::size_t i = 0; i != words.size(); ++ i) {
+        dense_symbol_type dense = alphabet.get_dense (words [i]);
+        BOOST_CHECK_EQUAL (dense.id(), int (i));
+        BOOST_CHECK_EQUAL (alphabet.template get_symbol <std::string> (dense),
+            words [i]);
+        // The alphabet with the special symbol shares the normal symbols.
+        BOOST_CHECK_EQUAL (alphabet2.get_dense (words [i]).id(), int (i));
+    }
+
+    BOOST_CHECK_THROW (alphabet.get_dense ("word10007"),
+        math::symbol_not_found_of <std::string>);
+    BOOST_CHECK_THROW (alphabet.get_dense (""),
+        math::symbol_not_found_of <std::string>);
+
+    // Integer symbols whose hash values differ only in the high bits.
+    typedef math::alphabet <int, word, 0xFFFFFF7F, meta::vector<>, 0x80,
+        SymbolMapping> int_alphabet_type;
+    int_alphabet_type int_alphabet;
+    for (int i = 0; i != 5000; ++ i)
+        BOOST_CHECK_EQUAL (int_alphabet.add_symbol (i << 16).id(), i);
+    for (int i = 0; i != 5000; ++ i)
+        BOOST_CHECK_EQUAL (int_alphabet.get_dense (i << 16).id(), i);
+    BOOST_CHECK_THROW (int_alphabet.get_dense (1), math::symbol_not_found);
+
+    // Overflow.
+    typedef math::alphabet <int, word, 3, meta::vector<>, 2, SymbolMapping>
+        small_alphabet_type;
+    small_alphabet_type small_alphabet;
+    small_alphabet.add_symbol (7);
+    small_alphabet.add_symbol (8);
+    small_alphabet.add_symbol (9);
+    BOOST_CHECK_THROW (small_alphabet.add_symbol (10), math::alphabet_overflow);
+    BOOST_CHECK_EQUAL (small_alphabet.add_symbol (8).id(), 1);
+}
+
+BOOST_AUTO_TEST_CASE (test_math_alphabet_symbol_mapping) {
+    check_many_symbols <math::hashed_symbol_mapping>();
+    check_many_symbols <math::ordered_symbol_mapping>();
+}
+
+/**
+Add and look up ranges of symbols, and check that the results are the same as
+for single symbols.
+*/
+template <class SymbolMapping> void check_bulk() {
+    typedef math::alphabet <std::string, word, 0xFFFFFF7F, meta::vector<>,
+        0x80, SymbolMapping> alphabet_type;
+    typedef typename alphabet_type::dense_symbol_type dense_symbol_type;
+    alphabet_type alphabet;
+    auto alphabet2 = math::add_special_symbol <empty> (alphabet);
+
+    alphabet.add_symbol ("first");
+
+    // More than one batch, with repetitions, and not a multiple of the batch
+    // size.
+    std::vector <std::string> words;
+    for (int i = 0; i != 1001; ++ i)
+        words.push_back ("word" + std::to_string ((i * 37) % 400));
+    words.push_back ("first");
+
+    std::vector <dense_symbol_type> dense (words.size());
+    alphabet.add_symbols (words, dense.data());
+    BOOST_CHECK_EQUAL (alphabet.normal_symbol_num(), 401u);
+    // New symbols are added in order of their first occurrence.
+    BOOST_CHECK_EQUAL (dense [0].id(), 1);
+    BOOST_CHECK_EQUAL (dense [1].id(), 2);
+    BOOST_CHECK_EQUAL (dense.back().id(), 0);
+    for (std::size_t i = 0; i != words.size(); ++ i) {
+        BOOST_CHECK (dense [i] == alphabet.get_dense (words [i]));
+        BOOST_CHECK_EQUAL (
+            alphabet.template get_symbol <std::string> (dense [i]), words [i]);
+    }
+
+    // Adding the same symbols again does not change anything.
+    alphabet2.add_symbols (words);
+    BOOST_CHECK_EQUAL (alphabet.normal_symbol_num(), 401u);
+
+    // Look up, with some symbols missing.
+    std::vector <std::string> queries;
+    for (int i = 0; i != 100; ++ i)
+        queries.push_back ("word" + std::to_string (i * 5));
+    std::vector <dense_symbol_type> found (queries.size());
+    std::unique_ptr <bool []> missing (new bool [queries.size()]);
+    BOOST_CHECK_EQUAL (alphabet2.get_dense (queries, found.data(),
+        missing.get()), 20u);
+    for (std::size_t i = 0; i != queries.size(); ++ i) {
+        BOOST_CHECK_EQUAL (missing [i], i * 5 >= 400);
+        if (!missing [i])
+            BOOST_CHECK (found [i] == alphabet.get_dense (queries [i]));
+    }
+
+    std::vector <std::string> none;
+    BOOST_CHECK_EQUAL (alphabet.get_dense (none, found.data(),
+        missing.get()), 0u);
+    alphabet.add_symbols (none);
+
+    // Overflow: the symbols that fit are added.
+    typedef math::alphabet <int, word, 3, meta::vector<>, 2, SymbolMapping>
+        small_alphabet_type;
+    small_alphabet_type small_alphabet;
+    std::vector <int> numbers = {7, 8, 7, 9, 10, 11};
+    BOOST_CHECK_THROW (small_alphabet.add_symbols (numbers),
+        math::alphabet_overflow);
+    BOOST_CHECK_EQUAL (small_alphabet.normal_symbol_num(), 3u);
+    BOOST_CHECK_EQUAL (small_alphabet.get_dense (9).id(), 2);
+}
+
+BOOST_AUTO_TEST_CASE (test_math_alphabet_bulk) {
+    check_bulk <math::hashed_symbol_mapping>();
+    check_bulk <math::ordered_symbol_mapping>();
+}
+
+/**
+Look up strings with keys of other types.
+*/
+template <class SymbolMapping> void check_string_keys() {
+    typedef math::alphabet <std::string, word, 0xFFFFFF7F, meta::vector<>,
+        0x80, SymbolMapping> alphabet_type;
+    typedef typename alphabet_type::dense_symbol_type dense_symbol_type;
+    alphabet_type alphabet;
+    auto alphabet2 = math::add_special_symbol <empty> (alphabet);
+
+    std::vector <std::string> words;
+    for (int i = 0; i != 2000; ++ i)
+        words.push_back ("word" + std::to_string (i));
+    words.push_back ("");
+    words.push_back (std::string ("a\0b", 3));
+    // Too long for the small string optimisation.
+    words.push_back (std::string (100000, 'x'));
+    alphabet.add_symbols (words);
+
+    for (std::size_t i = 0; i != words.size(); ++ i) {
+        boost::string_ref key (words [i]);
+        BOOST_CHECK_EQUAL (alphabet.get_dense (key).id(), int (i));
+        BOOST_CHECK_EQUAL (alphabet2.get_dense (key).id(), int (i));
+        std::string const & symbol =
+            alphabet.template get_symbol <std::string> (
+                alphabet.get_dense (key));
+        BOOST_CHECK_EQUAL (symbol, words [i]);
+        // The same object is returned every time.
+        BOOST_CHECK (&symbol == &alphabet.template get_symbol <std::string> (
+            alphabet.get_dense (words [i])));
+    }
+    BOOST_CHECK_EQUAL (alphabet.get_dense ("word17").id(), 17);
+    char const * pointer = "word18";
+    BOOST_CHECK_EQUAL (alphabet.get_dense (pointer).id(), 18);
+    // A key that points into a longer string.
+    std::string text = "word1999 word3";
+    BOOST_CHECK_EQUAL (alphabet.get_dense (boost::string_ref (
+        text.data(), 8)).id(), 1999);
+    BOOST_CHECK_EQUAL (alphabet.get_dense (boost::string_ref (
+        text.data() + 9, 5)).id(), 3);
+
+    try {
+        alphabet.get_dense (boost::string_ref (text));
+        BOOST_ERROR ("symbol_not_found_of should have been thrown.");
+    } catch (math::symbol_not_found_of <std::string> & error) {
+        BOOST_CHECK_EQUAL (error.symbol(), text);
+    }
+    BOOST_CHECK_THROW (alphabet.get_dense ("word"),
+        math::symbol_not_found_of <std::string>);
+
+    // Look up a range of keys.
+    std::vector <char const *> pointers = {"word5", "none", "word7"};
+    std::vector <dense_symbol_type> dense (pointers.size());
+    bool missing [3];
+    BOOST_CHECK_EQUAL (alphabet.get_dense (pointers, dense.data(), missing),
+        1u);
+    BOOST_CHECK (!missing [0] && missing [1] && !missing [2]);
+    BOOST_CHECK_EQUAL (dense [0].id(), 5);
+    BOOST_CHECK_EQUAL (dense [2].id(), 7);
+
+    std::vector <boost::string_ref> keys (words.begin(), words.end());
+    dense.resize (keys.size());
+    std::unique_ptr <bool []> missing2 (new bool [keys.size()]);
+    BOOST_CHECK_EQUAL (alphabet.get_dense (keys, dense.data(),
+        missing2.get()), 0u);
+    for (std::size_t i = 0; i != keys.size(); ++ i)
+        BOOST_CHECK_EQUAL (dense [i].id(), int (i));
+}
+
+BOOST_AUTO_TEST_CASE (test_math_alphabet_string_keys) {
+    check_string_keys <math::hashed_symbol_mapping>();
+    check_string_keys <math::ordered_symbol_mapping>();
+}
+
+/**
+Look up symbols on a number of threads while other threads add symbols.
+*/
+template <class SymbolMapping> void check_concurrent() {
+    typedef math::alphabet <std::string, word, 0xFFFFFF7F, meta::vector<>,
+        0x80, SymbolMapping> alphabet_type;
+    alphabet_type alphabet;
+    int const size = 20000;
+    std::atomic <bool> error (false);
+    std::atomic <int> added (0);
+
+    // The symbol for i is "i", and its dense symbol has id i.
+    auto read = [&]() {
+        while (added.load() != size) {
+            int current = added.load();
+            for (int i = (std::max) (0, current - 100); i < current; ++ i) {
+                auto dense = alphabet.get_dense (std::to_string (i));
+                if (dense.id() != i || alphabet.template get_symbol <
+                        std::string> (dense) != std::to_string (i))
+                    error = true;
+            }
+        }
+    };
+    // Adding symbols that are already in the alphabet does not change them.
+    auto add_again = [&]() {
+        while (added.load() != size) {
+            int i = added.load() - 1;
+            if (i >= 0 && alphabet.add_symbol (std::to_string (i)).id() != i)
+                error = true;
+        }
+    };
+
+    std::vector <std::thread> threads;
+    for (int i = 0; i != 3; ++ i)
+        threads.emplace_back (read);
+    threads.emplace_back (add_again);
+    for (int i = 0; i != size; ++ i) {
+        if (alphabet.add_symbol (std::to_string (i)).id() != i)
+            error = true;
+        added = i + 1;
+    }
+    for (std::thread & thread : threads)
+        thread.join();
+    BOOST_CHECK (!error);
+}
+
+// ordered_symbol_mapping does not lock, so only hashed_symbol_mapping can be
+// used like this.
+BOOST_AUTO_TEST_CASE (test_math_alphabet_concurrent) {
+    check_concurrent <math::hashed_symbol_mapping>();
+}
+
 BOOST_AUTO_TEST_SUITE_END()
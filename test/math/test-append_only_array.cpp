@@ -0,0 +1,111 @@
+/*
+Copyright 2026 Rogier van Dalen.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+
+/** \file
+Test detail/append_only_array.hpp.
+*/
+
+#define BOOST_TEST_MODULE test_append_only_array
+#include "utility/test/boost_unit_test.hpp"
+
+#include "math/detail/append_only_array.hpp"
+
+#include <atomic>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+BOOST_AUTO_TEST_SUITE (test_suite_append_only_array)
+
+BOOST_AUTO_TEST_CASE (test_highest_set_bit) {
+    BOOST_CHECK_EQUAL (math::detail::highest_set_bit (1), 0u);
+    BOOST_CHECK_EQUAL (math::detail::highest_set_bit (2), 1u);
+    BOOST_CHECK_EQUAL (math::detail::highest_set_bit (3), 1u);
+    BOOST_CHECK_EQUAL (math::detail::highest_set_bit (0x80000), 19u);
+    BOOST_CHECK_EQUAL (math::detail::highest_set_bit (~0ull), 63u);
+}
+
+BOOST_AUTO_TEST_CASE (test_append_only_array) {
+    math::detail::append_only_array <std::string> array;
+    BOOST_CHECK_EQUAL (array.size(), 0u);
+
+    std::vector <std::string const *> addresses;
+    for (int i = 0; i != 10000; ++ i) {
+        array.push_back (std::to_string (i));
+        BOOST_CHECK_EQUAL (array.size(), std::size_t (i + 1));
+        addresses.push_back (&array [i]);
+    }
+    for (int i = 0; i != 10000; ++ i) {
+        BOOST_CHECK_EQUAL (array [i], std::to_string (i));
+        // Elements are never moved.
+        BOOST_CHECK (&array [i] == addresses [i]);
+    }
+    // Within a segment, elements are contiguous.
+    BOOST_CHECK (&array [1] == &array [0] + 1);
+    BOOST_CHECK (&array [47] == &array [16] + 31);
+}
+
+/**
+Elements that cannot be copied, and whose destructors must be called.
+*/
+BOOST_AUTO_TEST_CASE (test_append_only_array_destruction) {
+    auto counter = std::make_shared <int> (0);
+    {
+        math::detail::append_only_array <std::shared_ptr <int>> array;
+        for (int i = 0; i != 100; ++ i)
+            array.emplace_back (counter);
+        BOOST_CHECK_EQUAL (counter.use_count(), 101);
+    }
+    BOOST_CHECK_EQUAL (counter.use_count(), 1);
+
+    math::detail::append_only_array <std::unique_ptr <int>> unique;
+    unique.emplace_back (new int (5));
+    BOOST_CHECK_EQUAL (*unique [0], 5);
+}
+
+/**
+Readers see only elements that have been constructed completely.
+*/
+BOOST_AUTO_TEST_CASE (test_append_only_array_concurrent) {
+    math::detail::append_only_array <std::vector <int>> array;
+    std::size_t const size = 100000;
+    std::atomic <bool> error (false);
+
+    auto read = [&]() {
+        std::size_t seen = 0;
+        while (seen != size) {
+            std::size_t current = array.size();
+            for (; seen != current; ++ seen) {
+                std::vector <int> const & element = array [seen];
+                if (element.size() != 3 || element [1] != int (seen))
+                    error = true;
+            }
+        }
+    };
+
+    std::vector <std::thread> readers;
+    for (int i = 0; i != 3; ++ i)
+        readers.emplace_back (read);
+    for (std::size_t i = 0; i != size; ++ i)
+        array.push_back (std::vector <int> {0, int (i), 0});
+    for (std::thread & reader : readers)
+        reader.join();
+    BOOST_CHECK (!error);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,143 @@
+/*
+Copyright 2026 Rogier van Dalen.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+
+/** \file
+Test arena.hpp.
+*/
+
+#define BOOST_TEST_MODULE test_arena
+#include "utility/test/boost_unit_test.hpp"
+
+#include "math/arena.hpp"
+
+#include <cstdint>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "math/detail/sequence_storage.hpp"
+#include "math/detail/sequence_intern_table.hpp"
+
+BOOST_AUTO_TEST_SUITE (test_suite_arena)
+
+BOOST_AUTO_TEST_CASE (test_arena) {
+    math::arena a (256);
+    BOOST_CHECK_EQUAL (a.allocated(), 0u);
+
+    char * previous = static_cast <char *> (a.allocate (1, 1));
+    for (std::size_t alignment = 1; alignment <= 16; alignment *= 2) {
+        char * memory = static_cast <char *> (a.allocate (3, alignment));
+        BOOST_CHECK_EQUAL (
+            reinterpret_cast <std::uintptr_t> (memory) % alignment, 0u);
+        BOOST_CHECK (memory != previous);
+        previous = memory;
+    }
+
+    // Larger than a chunk.
+    char * large = static_cast <char *> (a.allocate (1000, 8));
+    large [0] = 'a';
+    large [999] = 'b';
+    BOOST_CHECK (a.allocated() >= 1000u);
+
+    a.release();
+    BOOST_CHECK_EQUAL (a.allocated(), 0u);
+    a.allocate (10, 4);
+    BOOST_CHECK_EQUAL (a.allocated(), 10u);
+}
+
+BOOST_AUTO_TEST_CASE (test_arena_scope) {
+    math::arena a;
+    math::arena b;
+    BOOST_CHECK (math::arena::current() == nullptr);
+    {
+        math::arena_scope scope (a);
+        BOOST_CHECK (math::arena::current() == &a);
+        {
+            math::arena_scope inner (b);
+            BOOST_CHECK (math::arena::current() == &b);
+            {
+                math::arena_scope heap (nullptr);
+                BOOST_CHECK (math::arena::current() == nullptr);
+            }
+            BOOST_CHECK (math::arena::current() == &b);
+        }
+        BOOST_CHECK (math::arena::current() == &a);
+
+        // Other threads are not affected.
+        math::arena * other = &a;
+        std::thread thread ([&other]() { other = math::arena::current(); });
+        thread.join();
+        BOOST_CHECK (other == nullptr);
+    }
+    BOOST_CHECK (math::arena::current() == nullptr);
+}
+
+BOOST_AUTO_TEST_CASE (test_arena_sequence_storage) {
+    typedef math::detail::sequence_storage <std::string> storage;
+    std::vector <std::string> symbols;
+    for (int i = 0; i != 100; ++ i)
+        symbols.push_back (std::string (40, char ('a' + i % 26)));
+
+    math::arena a;
+    {
+        math::arena_scope scope (a);
+        storage in_arena (symbols.begin(), symbols.end());
+        BOOST_CHECK (!in_arena.is_inline());
+        BOOST_CHECK (a.allocated() >= 100 * sizeof (std::string));
+        BOOST_CHECK (std::vector <std::string> (
+            in_arena.begin(), in_arena.end()) == symbols);
+
+        std::size_t allocated = a.allocated();
+        // Copies share the block.
+        storage copy (in_arena);
+        BOOST_CHECK_EQUAL (a.allocated(), allocated);
+
+        // Short storage is inline, and does not use the arena.
+        storage short_storage (symbols.begin(), symbols.begin() + 1);
+        BOOST_CHECK (short_storage.is_inline());
+        BOOST_CHECK_EQUAL (a.allocated(), allocated);
+
+        // Growing allocates from the arena too.
+        copy.push_back ("z");
+        BOOST_CHECK (a.allocated() > allocated);
+    }
+
+    // Outside the scope, the heap is used.
+    std::size_t allocated = a.allocated();
+    storage on_heap (symbols.begin(), symbols.end());
+    BOOST_CHECK_EQUAL (a.allocated(), allocated);
+    a.release();
+}
+
+// Entries in the intern table may outlive the arena, so they do not use it.
+BOOST_AUTO_TEST_CASE (test_arena_intern_table) {
+    typedef math::detail::sequence_intern_table <int> table_type;
+    std::vector <int> symbols (100, 7);
+    table_type::entry * entry;
+    {
+        math::arena a;
+        math::arena_scope scope (a);
+        entry = table_type::instance().acquire (
+            symbols.data(), symbols.data() + symbols.size(), 5);
+        BOOST_CHECK_EQUAL (a.allocated(), 0u);
+    }
+    BOOST_CHECK (std::vector <int> (entry->symbols().begin(),
+        entry->symbols().end()) == symbols);
+    table_type::instance().release (entry);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
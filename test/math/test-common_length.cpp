@@ -0,0 +1,100 @@
+/*
+Copyright 2026 Rogier van Dalen.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+
+/** \file
+Test detail/common_length.hpp.
+*/
+
+#define BOOST_TEST_MODULE test_common_length
+#include "utility/test/boost_unit_test.hpp"
+
+#include "math/detail/common_length.hpp"
+
+#include <string>
+#include <vector>
+
+#include <boost/mpl/assert.hpp>
+
+#include "math/alphabet.hpp"
+
+BOOST_AUTO_TEST_SUITE (test_suite_common_length)
+
+using math::detail::common_prefix_length;
+using math::detail::common_suffix_length;
+
+BOOST_AUTO_TEST_CASE (test_is_bitwise_comparable) {
+    BOOST_MPL_ASSERT ((math::detail::is_bitwise_comparable <char>));
+    BOOST_MPL_ASSERT ((math::detail::is_bitwise_comparable <int>));
+    BOOST_MPL_ASSERT_NOT ((math::detail::is_bitwise_comparable <double>));
+    BOOST_MPL_ASSERT_NOT ((math::detail::is_bitwise_comparable <std::string>));
+    BOOST_MPL_ASSERT ((math::detail::is_bitwise_comparable <
+        math::alphabet <std::string>::dense_symbol_type>));
+}
+
+/**
+Compare the result with the straightforward implementation, for differences
+at every position, which falls in different blocks.
+*/
+template <class Symbol> void check_common_length (
+    Symbol const & symbol, Symbol const & other_symbol)
+{
+    std::size_t const size = 300;
+    std::vector <Symbol> symbols1 (size, symbol);
+    for (std::size_t i = 0; i < size; i += 7)
+        symbols1 [i] = other_symbol;
+
+    for (std::size_t position = 0; position <= size; ++ position) {
+        std::vector <Symbol> symbols2 = symbols1;
+        if (position != size)
+            symbols2 [position] = (symbols2 [position] == symbol)
+                ? other_symbol : symbol;
+
+        BOOST_CHECK_EQUAL (common_prefix_length (
+            symbols1.data(), symbols2.data(), size), position);
+        BOOST_CHECK_EQUAL (common_suffix_length (
+            symbols1.data() + size, symbols2.data() + size, size),
+            position == size ? size : size - position - 1);
+
+        // Limited by the size.
+        BOOST_CHECK_EQUAL (common_prefix_length (
+            symbols1.data(), symbols2.data(), position / 2), position / 2);
+    }
+
+    // The same memory.
+    BOOST_CHECK_EQUAL (common_prefix_length (
+        symbols1.data(), symbols1.data(), size), size);
+    BOOST_CHECK_EQUAL (common_suffix_length (
+        symbols1.data() + size, symbols1.data() + size, size), size);
+    BOOST_CHECK_EQUAL (common_prefix_length (
+        symbols1.data(), symbols1.data() + 7, size - 7), size - 7);
+}
+
+BOOST_AUTO_TEST_CASE (test_common_length) {
+    check_common_length <char> ('a', 'b');
+    check_common_length <int> (5, -70000);
+    check_common_length <long long> (1ll << 40, 3);
+    check_common_length <double> (.5, -.5);
+    check_common_length <std::string> ("a", "a longer string than fits inline");
+
+    // -0. and 0. compare equal but differ in their bits.
+    std::vector <double> zeros (100, 0.);
+    std::vector <double> negative_zeros (100, -0.);
+    BOOST_CHECK_EQUAL (common_prefix_length (
+        zeros.data(), negative_zeros.data(), 100), 100u);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
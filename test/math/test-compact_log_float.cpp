@@ -0,0 +1,317 @@
+/*
+Copyright 2026 Rogier van Dalen.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+/** \file
+Test compact_log_float.hpp.
+*/
+
+#define BOOST_TEST_MODULE compact_log_float
+#include "../boost_unit_test.hpp"
+
+#include "math/compact_log_float.hpp"
+
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <stdexcept>
+
+#include <boost/math/special_functions/fpclassify.hpp>
+
+BOOST_AUTO_TEST_SUITE(test_suite_compact_log_float)
+
+using boost::math::policies::policy;
+using boost::math::policies::overflow_error;
+using boost::math::policies::underflow_error;
+using boost::math::policies::ignore_error;
+using boost::math::policies::throw_on_error;
+
+BOOST_AUTO_TEST_CASE (test_fixed_point_log_float) {
+    typedef math::fixed_point_log_float <std::int16_t, 10> compact;
+    typedef math::log_float <double> log_float;
+    double const infinity = std::numeric_limits <double>::infinity();
+
+    static_assert (sizeof (compact) == 2, "");
+    static_assert (sizeof (math::fixed_point_log_float <std::int32_t, 20>)
+        == 4, "");
+
+    BOOST_CHECK_EQUAL (log_float (compact()).exponent(), -infinity);
+
+    // Representable values are kept exactly.
+    double const exact [] = {0, 1, -1, .5, -3.25, 1. / 1024, -20.0009765625};
+    for (double exponent : exact) {
+        compact c (log_float (exponent, math::as_exponent()));
+        BOOST_CHECK_EQUAL (c.exponent <double>(), exponent);
+        log_float l = c;
+        BOOST_CHECK_EQUAL (l.exponent(), exponent);
+        math::log_float <float> f = c;
+        BOOST_CHECK_EQUAL (f.exponent(), float (exponent));
+    }
+
+    // Rounding to nearest.
+    for (int i = -20000; i != 20000; ++ i) {
+        double exponent = i * .0013;
+        compact c (log_float (exponent, math::as_exponent()));
+        BOOST_CHECK_SMALL (c.exponent <double>() - exponent, 1. / 2048);
+    }
+    BOOST_CHECK_EQUAL (compact (log_float (.0012, math::as_exponent())).raw(),
+        1);
+    BOOST_CHECK_EQUAL (compact (log_float (-.0012, math::as_exponent())).raw(),
+        -1);
+
+    // Special values.
+    BOOST_CHECK_EQUAL (compact (log_float (-infinity, math::as_exponent()))
+        .exponent <double>(), -infinity);
+    BOOST_CHECK_EQUAL (compact (log_float (infinity, math::as_exponent()))
+        .exponent <double>(), infinity);
+    compact nan (log_float (std::numeric_limits <double>::quiet_NaN(),
+        math::as_exponent()));
+    BOOST_CHECK ((boost::math::isnan) (nan.exponent <double>()));
+    BOOST_CHECK (nan != nan);
+
+    compact one (log_float (1, math::as_exponent()));
+    BOOST_CHECK (one == compact (log_float (1, math::as_exponent())));
+    BOOST_CHECK (one != compact());
+
+    // Out of range.
+    BOOST_CHECK_THROW (compact (log_float (32, math::as_exponent())),
+        std::overflow_error);
+    // The default policy ignores underflow.
+    BOOST_CHECK_EQUAL (compact (log_float (-33, math::as_exponent()))
+        .exponent <double>(), -infinity);
+    BOOST_CHECK_EQUAL (compact (log_float (31.998, math::as_exponent()))
+        .exponent <double>(), 32766. / 1024);
+
+    typedef policy <overflow_error <ignore_error>, underflow_error <ignore_error>>
+        ignore_range;
+    typedef math::fixed_point_log_float <std::int16_t, 10, ignore_range>
+        ignore_compact;
+    typedef math::log_float <double, ignore_range> ignore_log_float;
+    BOOST_CHECK_EQUAL (ignore_compact (ignore_log_float (
+        100, math::as_exponent())).exponent <double>(), infinity);
+    BOOST_CHECK_EQUAL (ignore_compact (ignore_log_float (
+        -100, math::as_exponent())).exponent <double>(), -infinity);
+}
+
+/**
+With a 32-bit integer and float exponents, the highest and lowest values are
+not representable as float.
+*/
+BOOST_AUTO_TEST_CASE (test_fixed_point_log_float_wide) {
+    typedef policy <overflow_error <ignore_error>, underflow_error <ignore_error>>
+        ignore_range;
+    typedef math::fixed_point_log_float <std::int32_t, 0, ignore_range> compact;
+    typedef math::log_float <float, ignore_range> log_float;
+    float const infinity = std::numeric_limits <float>::infinity();
+
+    // 2^31 - 2 rounds to 2^31 in float, which does not fit in std::int32_t.
+    float const highest = float (std::numeric_limits <std::int32_t>::max() - 1);
+    BOOST_CHECK_EQUAL (compact (log_float (highest, math::as_exponent()))
+        .exponent <float>(), infinity);
+    float const lowest = float (std::numeric_limits <std::int32_t>::min() + 2);
+    BOOST_CHECK_EQUAL (compact (log_float (lowest, math::as_exponent()))
+        .exponent <float>(), -std::numeric_limits <float>::infinity());
+    BOOST_CHECK_EQUAL (compact (log_float (-lowest, math::as_exponent()))
+        .exponent <float>(), infinity);
+    BOOST_CHECK_EQUAL (compact (log_float (1e30f, math::as_exponent()))
+        .exponent <float>(), infinity);
+    BOOST_CHECK_EQUAL (compact (log_float (-1e30f, math::as_exponent()))
+        .exponent <float>(), -infinity);
+
+    // The largest floats below 2^31 in magnitude are stored exactly.
+    float const large = std::nextafter (float (1u << 31), 0.f);
+    BOOST_CHECK_EQUAL (compact (log_float (large, math::as_exponent()))
+        .exponent <float>(), large);
+    BOOST_CHECK_EQUAL (compact (log_float (-large, math::as_exponent()))
+        .exponent <float>(), -large);
+
+    // With double, the reserved values are representable.
+    typedef math::log_float <double, ignore_range> double_log_float;
+    double const highest_double = std::numeric_limits <std::int32_t>::max() - 1;
+    BOOST_CHECK_EQUAL (compact (double_log_float (
+        highest_double, math::as_exponent())).raw(), highest_double);
+    BOOST_CHECK_EQUAL (compact (double_log_float (
+        highest_double + 1, math::as_exponent())).exponent <double>(),
+        std::numeric_limits <double>::infinity());
+    double const lowest_double = std::numeric_limits <std::int32_t>::min() + 2;
+    BOOST_CHECK_EQUAL (compact (double_log_float (
+        lowest_double, math::as_exponent())).raw(), lowest_double);
+    BOOST_CHECK_EQUAL (compact (double_log_float (
+        lowest_double - 1, math::as_exponent())).exponent <double>(),
+        -std::numeric_limits <double>::infinity());
+}
+
+BOOST_AUTO_TEST_CASE (test_bfloat16_log_float) {
+    typedef math::bfloat16_log_float<> compact;
+    typedef math::log_float <float> log_float;
+    float const infinity = std::numeric_limits <float>::infinity();
+
+    static_assert (sizeof (compact) == 2, "");
+
+    BOOST_CHECK_EQUAL (log_float (compact()).exponent(), -infinity);
+
+    // Values with at most 8 significant bits are kept exactly.
+    float const exact [] = {0, 1, -1, .5f, -3.25f, -255, 1e30f, -1e-30f};
+    for (float exponent : exact) {
+        compact c (log_float (exponent, math::as_exponent()));
+        if (exponent == 1e30f || exponent == -1e-30f)
+            BOOST_CHECK_CLOSE (c.exponent(), exponent, .4);
+        else
+            BOOST_CHECK_EQUAL (c.exponent(), exponent);
+        math::log_float <double> l = c;
+        BOOST_CHECK_EQUAL (l.exponent(), c.exponent());
+    }
+
+    // Relative precision of the exponent.
+    for (int i = -1000; i != 1000; ++ i) {
+        float exponent = i * .37f;
+        compact c (log_float (exponent, math::as_exponent()));
+        BOOST_CHECK (std::abs (c.exponent() - exponent)
+            <= std::abs (exponent) / 256);
+    }
+
+    // Round to nearest, ties to even.
+    // 1 + 2^-8 is exactly halfway between 1 and 1 + 2^-7.
+    BOOST_CHECK_EQUAL (compact (log_float (1 + 1.f / 256, math::as_exponent()))
+        .exponent(), 1.f);
+    BOOST_CHECK_EQUAL (compact (log_float (1 + 3.f / 256, math::as_exponent()))
+        .exponent(), 1 + 4.f / 256);
+    BOOST_CHECK_EQUAL (compact (log_float (1 + 1.1f / 256,
+        math::as_exponent())).exponent(), 1 + 2.f / 256);
+
+    // Special values.
+    BOOST_CHECK_EQUAL (compact (log_float (infinity, math::as_exponent()))
+        .exponent(), infinity);
+    compact nan (log_float (std::numeric_limits <float>::quiet_NaN(),
+        math::as_exponent()));
+    BOOST_CHECK ((boost::math::isnan) (nan.exponent()));
+    BOOST_CHECK (nan != nan);
+
+    // Overflow when rounding up to infinity.
+    BOOST_CHECK_THROW (compact (log_float (std::numeric_limits <float>::max(),
+        math::as_exponent())), std::overflow_error);
+    BOOST_CHECK_THROW (math::bfloat16_log_float <> (math::log_float <double> (
+        1e300, math::as_exponent())), std::overflow_error);
+
+    typedef policy <overflow_error <ignore_error>> ignore_overflow;
+    BOOST_CHECK_EQUAL ((math::bfloat16_log_float <ignore_overflow> (
+        math::log_float <double, ignore_overflow> (1e300, math::as_exponent()))
+        .exponent()), infinity);
+    // Exponents too small for float; the default policy ignores underflow.
+    BOOST_CHECK_EQUAL ((math::bfloat16_log_float <> (math::log_float <double> (
+        -1e300, math::as_exponent())).exponent()), -infinity);
+    typedef policy <underflow_error <throw_on_error>> throw_underflow;
+    BOOST_CHECK_THROW (math::bfloat16_log_float <throw_underflow> (
+        math::log_float <double, throw_underflow> (
+            -1e300, math::as_exponent())), std::underflow_error);
+}
+
+template <class Exponent> void check_packed_signed_log_float() {
+    typedef math::packed_signed_log_float <Exponent> packed;
+    typedef math::signed_log_float <Exponent> signed_log_float;
+    Exponent const infinity = std::numeric_limits <Exponent>::infinity();
+    Exponent const epsilon = std::numeric_limits <Exponent>::epsilon();
+
+    static_assert (sizeof (packed) == sizeof (Exponent), "");
+
+    signed_log_float zero = packed();
+    BOOST_CHECK_EQUAL (zero.exponent(), -infinity);
+    BOOST_CHECK_EQUAL (zero.sign(), +1);
+
+    Exponent const exponents [] = {-infinity, -1000, -2.5, -epsilon, 0, 1,
+        Exponent (1) / 3, 7.25, 1e30f, std::numeric_limits <Exponent>::max(),
+        infinity};
+    for (Exponent exponent : exponents) {
+        for (int sign = -1; sign <= +1; sign += 2) {
+            signed_log_float value (exponent, sign, math::as_exponent());
+            packed p (value);
+            BOOST_CHECK_EQUAL (p.sign(), sign);
+            // Rounded towards zero by at most one unit in the last place.
+            BOOST_CHECK (std::abs (p.exponent()) <= std::abs (exponent));
+            if ((boost::math::isinf) (exponent))
+                BOOST_CHECK_EQUAL (p.exponent(), exponent);
+            else
+                BOOST_CHECK (std::abs (p.exponent() - exponent)
+                    <= std::abs (exponent) * epsilon);
+            signed_log_float back = p;
+            BOOST_CHECK_EQUAL (back.sign(), sign);
+            BOOST_CHECK_EQUAL (back.exponent(), p.exponent());
+            // Converting again does not change the value.
+            BOOST_CHECK_EQUAL (packed (back).exponent(), p.exponent());
+        }
+    }
+
+    packed nan (signed_log_float (std::numeric_limits <Exponent>::quiet_NaN(),
+        -1, math::as_exponent()));
+    BOOST_CHECK ((boost::math::isnan) (nan.exponent()));
+    BOOST_CHECK_EQUAL (nan.sign(), -1);
+
+    packed from_log_float (math::log_float <Exponent> (
+        2, math::as_exponent()));
+    BOOST_CHECK_EQUAL (from_log_float.sign(), +1);
+    BOOST_CHECK_EQUAL (from_log_float.exponent(), 2);
+
+    // Arithmetic through signed_log_float.
+    packed a (signed_log_float (Exponent (-3)));
+    packed b (signed_log_float (Exponent (5)));
+    signed_log_float sum = signed_log_float (a) + signed_log_float (b);
+    BOOST_CHECK_CLOSE (sum.get(), Exponent (2), 1e-4);
+
+    // Comparison.
+    BOOST_CHECK (a == packed (signed_log_float (Exponent (-3))));
+    BOOST_CHECK (!(a != packed (signed_log_float (Exponent (-3)))));
+    BOOST_CHECK (a != b);
+    BOOST_CHECK (!(a == b));
+    // Same exponent, different sign.
+    BOOST_CHECK (a != packed (signed_log_float (Exponent (3))));
+    BOOST_CHECK (b != packed (signed_log_float (Exponent (-5))));
+    // Zeros are equal whatever their sign.
+    packed minus_zero (signed_log_float (-infinity, -1, math::as_exponent()));
+    BOOST_CHECK (minus_zero == packed());
+    BOOST_CHECK (!(minus_zero != packed()));
+    BOOST_CHECK (packed() == packed (math::log_float <Exponent> (0)));
+    // Infinities are not.
+    packed plus_infinity (signed_log_float (infinity, +1, math::as_exponent()));
+    packed minus_infinity (
+        signed_log_float (infinity, -1, math::as_exponent()));
+    BOOST_CHECK (plus_infinity == plus_infinity);
+    BOOST_CHECK (plus_infinity != minus_infinity);
+    // NaN is not equal to anything.
+    BOOST_CHECK (nan != nan);
+    BOOST_CHECK (!(nan == nan));
+    BOOST_CHECK (nan != packed());
+    // Comparison agrees with signed_log_float.
+    for (Exponent exponent : exponents) {
+        for (int sign = -1; sign <= +1; sign += 2) {
+            packed p (signed_log_float (exponent, sign, math::as_exponent()));
+            for (Exponent exponent2 : exponents) {
+                for (int sign2 = -1; sign2 <= +1; sign2 += 2) {
+                    packed p2 (signed_log_float (
+                        exponent2, sign2, math::as_exponent()));
+                    BOOST_CHECK_EQUAL (p == p2,
+                        signed_log_float (p) == signed_log_float (p2));
+                    BOOST_CHECK_EQUAL (p != p2, !(p == p2));
+                }
+            }
+        }
+    }
+}
+
+BOOST_AUTO_TEST_CASE (test_packed_signed_log_float) {
+    check_packed_signed_log_float <float>();
+    check_packed_signed_log_float <double>();
+}
+
+BOOST_AUTO_TEST_SUITE_END()
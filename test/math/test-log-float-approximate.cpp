@@ -0,0 +1,132 @@
+/*
+Copyright 2026 Rogier van Dalen.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+/** \file
+Test addition of log_float with a policy that asks for low precision, so that
+a table is used instead of log1p and exp.
+*/
+
+#define BOOST_TEST_MODULE log_float_approximate
+#include "../boost_unit_test.hpp"
+
+#include "math/log-float.hpp"
+
+#include <cmath>
+#include <limits>
+
+#include <boost/math/special_functions/fpclassify.hpp>
+
+BOOST_AUTO_TEST_SUITE(test_suite_log_float_approximate)
+
+using boost::math::policies::policy;
+using boost::math::policies::digits10;
+using boost::math::policies::digits2;
+using boost::math::policies::overflow_error;
+using boost::math::policies::ignore_error;
+
+using math::table_addition_policy;
+
+static_assert (!math::detail::use_log1p_exp_table <policy<>>::value,
+    "The default policy should use the exact implementation.");
+static_assert (!math::detail::use_log1p_exp_table <
+        policy <digits10 <4>>>::value,
+    "A low precision alone should not switch to the table.");
+static_assert (math::detail::use_log1p_exp_table <
+        table_addition_policy<>>::value,
+    "table_addition_policy should use the table.");
+static_assert (math::detail::use_log1p_exp_table <
+        table_addition_policy <policy <digits2 <40>>>>::value,
+    "table_addition_policy should use the table whatever the precision.");
+
+/**
+Compare approximate addition against exact addition on a fine grid of
+differences, including beyond the cutoff.
+*/
+template <class RealType, class Policy> void check_approximate_addition() {
+    typedef math::log_float <RealType, Policy> approximate;
+    typedef math::log_float <RealType> exact;
+    RealType const infinity = std::numeric_limits <RealType>::infinity();
+
+    RealType const bound = RealType (std::ldexp (1., -16));
+    RealType largest_error = 0;
+    for (int i = 0; i <= 20000; ++ i) {
+        RealType a = RealType (-3.25);
+        RealType b = a - RealType (i) / 1000;
+        RealType result = (approximate (a, math::as_exponent())
+            + approximate (b, math::as_exponent())).exponent();
+        RealType reference = (exact (a, math::as_exponent())
+            + exact (b, math::as_exponent())).exponent();
+        // The error in the exponent is the relative error in the value.
+        using std::abs;
+        RealType error = abs (result - reference);
+        if (error > largest_error)
+            largest_error = error;
+        // Commutative.
+        BOOST_CHECK_EQUAL ((approximate (b, math::as_exponent())
+            + approximate (a, math::as_exponent())).exponent(), result);
+    }
+    BOOST_CHECK_LT (largest_error, bound);
+
+    // Corner cases are the same as for the exact implementation.
+    RealType const special [] = {-infinity, -1, 0, 2, infinity,
+        std::numeric_limits <RealType>::quiet_NaN()};
+    for (RealType a : special) {
+        for (RealType b : special) {
+            RealType result = (approximate (a, math::as_exponent())
+                + approximate (b, math::as_exponent())).exponent();
+            RealType reference = (exact (a, math::as_exponent())
+                + exact (b, math::as_exponent())).exponent();
+            if ((boost::math::isinf) (a) || (boost::math::isinf) (b)
+                    || (boost::math::isnan) (a) || (boost::math::isnan) (b))
+            {
+                if ((boost::math::isnan) (reference))
+                    BOOST_CHECK ((boost::math::isnan) (result));
+                else
+                    BOOST_CHECK_EQUAL (result, reference);
+            } else {
+                using std::abs;
+                BOOST_CHECK_LT (abs (result - reference), bound);
+            }
+        }
+    }
+}
+
+BOOST_AUTO_TEST_CASE (test_log_float_approximate_addition) {
+    check_approximate_addition <float, table_addition_policy<>>();
+    check_approximate_addition <double, table_addition_policy<>>();
+    check_approximate_addition <double,
+        table_addition_policy <policy <digits2 <12>>>>();
+    check_approximate_addition <double,
+        table_addition_policy <policy <overflow_error <ignore_error>>>>();
+}
+
+/**
+Addition with a policy that only asks for a low precision is exact.
+*/
+BOOST_AUTO_TEST_CASE (test_log_float_low_precision_exact) {
+    typedef math::log_float <double, policy <digits10 <4>>> low_precision;
+    typedef math::log_float <double> exact;
+    for (int i = 0; i <= 200; ++ i) {
+        double a = -1.5;
+        double b = a - double (i) / 16;
+        BOOST_CHECK_EQUAL ((low_precision (a, math::as_exponent())
+                + low_precision (b, math::as_exponent())).exponent(),
+            (exact (a, math::as_exponent())
+                + exact (b, math::as_exponent())).exponent());
+    }
+}
+
+BOOST_AUTO_TEST_SUITE_END()
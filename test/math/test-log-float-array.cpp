@@ -0,0 +1,269 @@
+/*
+Copyright 2026 Rogier van Dalen.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+/** \file
+Test log-float_array.hpp.
+The array operations must give exactly the same results as the scalar
+operations.
+*/
+
+#define BOOST_TEST_MODULE log_float_array
+#include "../boost_unit_test.hpp"
+
+#include "math/log-float_array.hpp"
+
+#include <cmath>
+#include <vector>
+#include <limits>
+#include <stdexcept>
+
+#include <boost/math/special_functions/fpclassify.hpp>
+
+BOOST_AUTO_TEST_SUITE(test_suite_log_float_array)
+
+using boost::math::policies::policy;
+using boost::math::policies::overflow_error;
+using boost::math::policies::ignore_error;
+
+/**
+Exponents that exercise all corner cases of addition, in combination with
+each other.
+*/
+template <class RealType> std::vector <RealType> example_exponents() {
+    RealType const infinity = std::numeric_limits <RealType>::infinity();
+    RealType const max = std::numeric_limits <RealType>::max();
+    std::vector <RealType> examples;
+    examples.push_back (-infinity);
+    examples.push_back (-max);
+    examples.push_back (-1000);
+    examples.push_back (-3.5);
+    examples.push_back (-.25);
+    examples.push_back (-0.);
+    examples.push_back (0);
+    examples.push_back (.25);
+    examples.push_back (7);
+    examples.push_back (1000);
+    examples.push_back (max / 2);
+    examples.push_back (infinity);
+    examples.push_back (std::numeric_limits <RealType>::quiet_NaN());
+    return examples;
+}
+
+template <class RealType>
+    bool same_exponent (RealType const & left, RealType const & right)
+{
+    if ((boost::math::isnan) (left))
+        return (boost::math::isnan) (right);
+    return left == right;
+}
+
+/**
+Add all pairs of examples, repeated so that the arrays span more than one
+block, and check against operator+.
+*/
+template <class RealType, class Policy> void check_add() {
+    typedef math::log_float <RealType, Policy> log_float;
+    std::vector <RealType> exponents = example_exponents <RealType>();
+
+    std::vector <log_float> left, right;
+    for (int repetition = 0; repetition != 3; ++ repetition) {
+        for (RealType a : exponents) {
+            for (RealType b : exponents) {
+                left.push_back (log_float (a, math::as_exponent()));
+                right.push_back (log_float (b, math::as_exponent()));
+            }
+        }
+    }
+
+    std::vector <log_float> result (left.size());
+    log_float * end = math::add (left.data(), left.data() + left.size(),
+        right.data(), result.data());
+    BOOST_CHECK (end == result.data() + result.size());
+
+    for (std::size_t i = 0; i != left.size(); ++ i) {
+        log_float expected = left [i] + right [i];
+        BOOST_CHECK (same_exponent (result [i].exponent(),
+            expected.exponent()));
+    }
+
+    // In place.
+    std::vector <log_float> in_place = left;
+    math::add (in_place.data(), in_place.data() + in_place.size(),
+        right.data(), in_place.data());
+    for (std::size_t i = 0; i != left.size(); ++ i)
+        BOOST_CHECK (same_exponent (in_place [i].exponent(),
+            result [i].exponent()));
+}
+
+BOOST_AUTO_TEST_CASE (test_log_float_array_add) {
+    typedef policy <overflow_error <ignore_error>> ignore_overflow;
+    check_add <float, ignore_overflow>();
+    check_add <double, ignore_overflow>();
+    check_add <float, policy<>>();
+    check_add <double, policy<>>();
+
+    // With the default policy.
+    typedef math::log_float <double> log_float;
+    std::vector <log_float> left, right;
+    for (int i = 0; i != 1000; ++ i) {
+        left.push_back (log_float ((i % 37) * -.75, math::as_exponent()));
+        right.push_back (log_float ((i % 11) * -3.25, math::as_exponent()));
+    }
+    left [500] = log_float();
+    right [500] = log_float();
+    left [501] = log_float (
+        std::numeric_limits <double>::infinity(), math::as_exponent());
+
+    std::vector <log_float> result (left.size());
+    math::add (left.data(), left.data() + left.size(), right.data(),
+        result.data());
+    for (std::size_t i = 0; i != left.size(); ++ i)
+        BOOST_CHECK_EQUAL (result [i].exponent(),
+            (left [i] + right [i]).exponent());
+}
+
+template <class RealType> void check_to_log_float() {
+    typedef math::log_float <RealType> log_float;
+    std::vector <RealType> values;
+    for (int i = 0; i != 600; ++ i)
+        values.push_back (RealType (i % 17) / 8);
+    values.push_back (std::numeric_limits <RealType>::infinity());
+    values.push_back (std::numeric_limits <RealType>::quiet_NaN());
+    values.push_back (std::numeric_limits <RealType>::min());
+    values.push_back (std::numeric_limits <RealType>::max() / 2);
+
+    std::vector <log_float> result (values.size());
+    log_float * end = math::to_log_float (values.data(),
+        values.data() + values.size(), result.data());
+    BOOST_CHECK (end == result.data() + result.size());
+    for (std::size_t i = 0; i != values.size(); ++ i) {
+        BOOST_CHECK (same_exponent (result [i].exponent(),
+            log_float (values [i]).exponent()));
+    }
+
+    std::vector <RealType> back (result.size());
+    RealType * back_end = math::from_log_float (result.data(),
+        result.data() + result.size(), back.data());
+    BOOST_CHECK (back_end == back.data() + back.size());
+    for (std::size_t i = 0; i != result.size(); ++ i)
+        BOOST_CHECK (same_exponent (back [i], result [i].get()));
+}
+
+BOOST_AUTO_TEST_CASE (test_log_float_array_conversion) {
+    check_to_log_float <float>();
+    check_to_log_float <double>();
+
+    typedef math::log_float <double> log_float;
+    std::vector <double> values (1000, .5);
+    values [700] = -1;
+    std::vector <log_float> result (values.size());
+    BOOST_CHECK_THROW (math::to_log_float (values.data(),
+        values.data() + values.size(), result.data()), std::domain_error);
+
+    std::vector <log_float> large (1000, log_float (1, math::as_exponent()));
+    large [300] = log_float (1000, math::as_exponent());
+    std::vector <double> linear (large.size());
+    BOOST_CHECK_THROW (math::from_log_float (large.data(),
+        large.data() + large.size(), linear.data()), std::overflow_error);
+
+    // With errors ignored, negative values become NaN.
+    using boost::math::policies::domain_error;
+    typedef policy <domain_error <ignore_error>, overflow_error <ignore_error>>
+        ignore_policy;
+    typedef math::log_float <double, ignore_policy> ignore_log_float;
+    std::vector <ignore_log_float> ignore_result (values.size());
+    values [701] = -2;
+    math::to_log_float (values.data(), values.data() + values.size(),
+        ignore_result.data());
+    BOOST_CHECK ((boost::math::isnan) (ignore_result [700].exponent()));
+    BOOST_CHECK ((boost::math::isnan) (ignore_result [701].exponent()));
+    BOOST_CHECK_EQUAL (ignore_result [702].exponent(), std::log (.5));
+
+    ignore_result [10] = ignore_log_float (1000, math::as_exponent());
+    math::from_log_float (ignore_result.data(),
+        ignore_result.data() + ignore_result.size(), linear.data());
+    BOOST_CHECK_EQUAL (linear [10], std::numeric_limits <double>::infinity());
+    BOOST_CHECK_EQUAL (linear [11], .5);
+}
+
+BOOST_AUTO_TEST_CASE (test_log_float_array_pairwise_sum) {
+    typedef math::log_float <double> log_float;
+    typedef math::signed_log_float <double> signed_log_float;
+
+    std::vector <log_float> empty;
+    BOOST_CHECK_EQUAL (math::pairwise_sum (empty.data(), empty.data())
+        .exponent(), -std::numeric_limits <double>::infinity());
+
+    std::vector <log_float> values;
+    long double reference_sum = 0;
+    for (int i = 0; i != 100001; ++ i) {
+        double exponent = -.001 * ((i * 7919) % 10007);
+        values.push_back (log_float (exponent, math::as_exponent()));
+        reference_sum += std::exp ((long double) exponent);
+    }
+    double reference = double (std::log (reference_sum));
+
+    log_float sequential;
+    for (log_float value : values)
+        sequential += value;
+    log_float pairwise = math::pairwise_sum (
+        values.data(), values.data() + values.size());
+    BOOST_CHECK (std::abs (pairwise.exponent() - reference)
+        <= std::abs (sequential.exponent() - reference));
+    BOOST_CHECK_CLOSE (pairwise.exponent(), reference, 1e-11);
+
+    // Summing the two halves of the tree separately gives the same result.
+    std::size_t half = values.size() / 2;
+    log_float left = math::pairwise_sum (values.data(), values.data() + half);
+    log_float right = math::pairwise_sum (
+        values.data() + half, values.data() + values.size());
+    BOOST_CHECK_EQUAL ((left + right).exponent(), pairwise.exponent());
+
+    // Summing on more threads gives the same result.
+    for (std::size_t thread_num : {0, 1, 2, 3, 4, 7, 16}) {
+        BOOST_CHECK_EQUAL (math::pairwise_sum (values.data(),
+            values.data() + values.size(), thread_num).exponent(),
+            pairwise.exponent());
+        BOOST_CHECK_EQUAL (math::pairwise_sum (values.data(),
+            values.data() + 1000, thread_num).exponent(),
+            math::pairwise_sum (values.data(), values.data() + 1000)
+                .exponent());
+    }
+    BOOST_CHECK_EQUAL (math::pairwise_sum (empty.data(), empty.data(), 4)
+        .exponent(), -std::numeric_limits <double>::infinity());
+
+    // Signed values.
+    std::vector <signed_log_float> signed_values;
+    double linear_sum = 0;
+    for (int i = 0; i != 1000; ++ i) {
+        double value = (i % 3 == 0 ? -1 : 1) * (1 + (i % 7));
+        signed_values.push_back (signed_log_float (value));
+        linear_sum += value;
+    }
+    signed_log_float signed_sum = math::pairwise_sum (
+        signed_values.data(), signed_values.data() + signed_values.size());
+    BOOST_CHECK_CLOSE (signed_sum.get(), linear_sum, 1e-9);
+    BOOST_CHECK (math::pairwise_sum (signed_values.data(),
+        signed_values.data() + signed_values.size(), 4) == signed_sum);
+
+    signed_values.push_back (signed_log_float (
+        std::numeric_limits <double>::quiet_NaN()));
+    BOOST_CHECK ((boost::math::isnan) (math::pairwise_sum (
+        signed_values.data(), signed_values.data() + signed_values.size())
+        .exponent()));
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,189 @@
+/*
+Copyright 2026 Rogier van Dalen.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+/** \file
+Test how multiplication and division of log_float and signed_log_float handle
+errors.
+These operations compute the result first, and check for errors only if the
+result is not finite.
+This tests that path, with policies that throw and that set errno.
+*/
+
+#define BOOST_TEST_MODULE log_float_multiply_errors
+#include "../boost_unit_test.hpp"
+
+#include "math/log-float.hpp"
+
+#include <cerrno>
+#include <limits>
+#include <stdexcept>
+
+#include <boost/math/special_functions/fpclassify.hpp>
+
+BOOST_AUTO_TEST_SUITE(test_suite_log_float_multiply_errors)
+
+using boost::math::policies::policy;
+using boost::math::policies::overflow_error;
+using boost::math::policies::underflow_error;
+using boost::math::policies::indeterminate_result_error;
+using boost::math::policies::throw_on_error;
+using boost::math::policies::errno_on_error;
+
+typedef policy <overflow_error <throw_on_error>,
+    underflow_error <throw_on_error>,
+    indeterminate_result_error <throw_on_error>> throw_policy;
+
+typedef policy <overflow_error <errno_on_error>,
+    underflow_error <errno_on_error>,
+    indeterminate_result_error <errno_on_error>> errno_policy;
+
+/**
+Values to multiply and divide, with exponents at the limits of RealType.
+*/
+template <class LogFloat> struct operands {
+    typedef typename LogFloat::exponent_type exponent_type;
+    typedef std::numeric_limits <exponent_type> limits;
+
+    LogFloat one, large, small, zero, infinity, not_a_number;
+
+    operands()
+    : one (0, math::as_exponent()),
+        large (limits::max(), math::as_exponent()),
+        small (-limits::max(), math::as_exponent()),
+        zero (-limits::infinity(), math::as_exponent()),
+        infinity (limits::infinity(), math::as_exponent()),
+        not_a_number (limits::quiet_NaN(), math::as_exponent()) {}
+};
+
+template <class LogFloat> void check_throw() {
+    operands <LogFloat> v;
+
+    // Overflow.
+    BOOST_CHECK_THROW (v.large * v.large, std::overflow_error);
+    BOOST_CHECK_THROW (v.large / v.small, std::overflow_error);
+    BOOST_CHECK_THROW (v.one / v.zero, std::overflow_error);
+    // Underflow.
+    BOOST_CHECK_THROW (v.small * v.small, std::underflow_error);
+    BOOST_CHECK_THROW (v.small / v.large, std::underflow_error);
+    // 0 * inf, 0 / 0, and inf / inf are undefined.
+    BOOST_CHECK_THROW (v.zero * v.infinity, std::domain_error);
+    BOOST_CHECK_THROW (v.infinity * v.zero, std::domain_error);
+    BOOST_CHECK_THROW (v.zero / v.zero, std::domain_error);
+    BOOST_CHECK_THROW (v.infinity / v.infinity, std::domain_error);
+
+    // The compound assignment operators raise the same errors.
+    LogFloat large = v.large;
+    BOOST_CHECK_THROW (large *= v.large, std::overflow_error);
+    LogFloat small = v.small;
+    BOOST_CHECK_THROW (small /= v.large, std::underflow_error);
+    LogFloat zero = v.zero;
+    BOOST_CHECK_THROW (zero *= v.infinity, std::domain_error);
+}
+
+template <class LogFloat> void check_results() {
+    typedef typename LogFloat::exponent_type exponent_type;
+    exponent_type const infinity =
+        std::numeric_limits <exponent_type>::infinity();
+    operands <LogFloat> v;
+
+    // NaN propagates, without an error.
+    errno = 0;
+    BOOST_CHECK ((boost::math::isnan) ((v.not_a_number * v.one).exponent()));
+    BOOST_CHECK ((boost::math::isnan) ((v.one * v.not_a_number).exponent()));
+    BOOST_CHECK ((boost::math::isnan) (
+        (v.not_a_number * v.infinity).exponent()));
+    BOOST_CHECK ((boost::math::isnan) ((v.not_a_number / v.zero).exponent()));
+    BOOST_CHECK ((boost::math::isnan) ((v.zero / v.not_a_number).exponent()));
+
+    // Infinities and zeros that do not cause errors.
+    BOOST_CHECK_EQUAL ((v.infinity * v.infinity).exponent(), infinity);
+    BOOST_CHECK_EQUAL ((v.infinity * v.one).exponent(), infinity);
+    BOOST_CHECK_EQUAL ((v.zero * v.zero).exponent(), -infinity);
+    BOOST_CHECK_EQUAL ((v.one * v.zero).exponent(), -infinity);
+    BOOST_CHECK_EQUAL ((v.infinity / v.zero).exponent(), infinity);
+    BOOST_CHECK_EQUAL ((v.infinity / v.one).exponent(), infinity);
+    BOOST_CHECK_EQUAL ((v.one / v.infinity).exponent(), -infinity);
+    BOOST_CHECK_EQUAL ((v.zero / v.one).exponent(), -infinity);
+    BOOST_CHECK_EQUAL ((v.zero / v.infinity).exponent(), -infinity);
+    BOOST_CHECK_EQUAL (errno, 0);
+
+    // Overflow.
+    BOOST_CHECK_EQUAL ((v.large * v.large).exponent(), infinity);
+    BOOST_CHECK_EQUAL (errno, ERANGE);
+    errno = 0;
+    BOOST_CHECK_EQUAL ((v.one / v.zero).exponent(), infinity);
+    BOOST_CHECK_EQUAL (errno, ERANGE);
+    errno = 0;
+    BOOST_CHECK_EQUAL ((v.large / v.small).exponent(), infinity);
+    BOOST_CHECK_EQUAL (errno, ERANGE);
+
+    // Underflow.
+    errno = 0;
+    BOOST_CHECK_EQUAL ((v.small * v.small).exponent(), -infinity);
+    BOOST_CHECK_EQUAL (errno, ERANGE);
+    errno = 0;
+    BOOST_CHECK_EQUAL ((v.small / v.large).exponent(), -infinity);
+    BOOST_CHECK_EQUAL (errno, ERANGE);
+
+    // Undefined results.
+    errno = 0;
+    BOOST_CHECK ((boost::math::isnan) ((v.zero * v.infinity).exponent()));
+    BOOST_CHECK_EQUAL (errno, EDOM);
+    errno = 0;
+    BOOST_CHECK ((boost::math::isnan) ((v.zero / v.zero).exponent()));
+    BOOST_CHECK_EQUAL (errno, EDOM);
+    errno = 0;
+    BOOST_CHECK ((boost::math::isnan) ((v.infinity / v.infinity).exponent()));
+    BOOST_CHECK_EQUAL (errno, EDOM);
+}
+
+BOOST_AUTO_TEST_CASE (test_log_float_multiply_errors_throw) {
+    check_throw <math::log_float <float, throw_policy>>();
+    check_throw <math::log_float <double, throw_policy>>();
+    check_throw <math::signed_log_float <float, throw_policy>>();
+    check_throw <math::signed_log_float <double, throw_policy>>();
+}
+
+BOOST_AUTO_TEST_CASE (test_log_float_multiply_errors_errno) {
+    check_results <math::log_float <float, errno_policy>>();
+    check_results <math::log_float <double, errno_policy>>();
+    check_results <math::signed_log_float <float, errno_policy>>();
+    check_results <math::signed_log_float <double, errno_policy>>();
+}
+
+/**
+The sign of signed_log_float does not change which errors are raised.
+*/
+BOOST_AUTO_TEST_CASE (test_signed_log_float_multiply_errors_sign) {
+    typedef math::signed_log_float <double, throw_policy> signed_log_float;
+    typedef std::numeric_limits <double> limits;
+    signed_log_float minus_large (limits::max(), -1, math::as_exponent());
+    signed_log_float large (limits::max(), +1, math::as_exponent());
+    signed_log_float minus_zero (-limits::infinity(), -1, math::as_exponent());
+    signed_log_float minus_infinity (
+        limits::infinity(), -1, math::as_exponent());
+
+    BOOST_CHECK_THROW (minus_large * large, std::overflow_error);
+    BOOST_CHECK_THROW (minus_large * minus_large, std::overflow_error);
+    BOOST_CHECK_THROW (minus_zero * minus_infinity, std::domain_error);
+    BOOST_CHECK_THROW (minus_infinity / minus_infinity, std::domain_error);
+
+    signed_log_float product = minus_infinity * large;
+    BOOST_CHECK_EQUAL (product.exponent(), limits::infinity());
+    BOOST_CHECK_EQUAL (product.sign(), -1);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,130 @@
+/*
+Copyright 2026 Rogier van Dalen.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+/** \file
+Test log_sum_accumulator.hpp.
+*/
+
+#define BOOST_TEST_MODULE log_sum_accumulator
+#include "../boost_unit_test.hpp"
+
+#include "math/log_sum_accumulator.hpp"
+
+#include <cmath>
+#include <limits>
+#include <vector>
+
+#include <boost/math/special_functions/fpclassify.hpp>
+
+BOOST_AUTO_TEST_SUITE(test_suite_log_sum_accumulator)
+
+BOOST_AUTO_TEST_CASE (test_log_sum_accumulator_special) {
+    typedef math::log_float <double> log_float;
+    typedef math::log_sum_accumulator <double> accumulator;
+    double const infinity = std::numeric_limits <double>::infinity();
+
+    {
+        accumulator a;
+        BOOST_CHECK_EQUAL (a.sum().exponent(), -infinity);
+        a += log_float();
+        a += log_float();
+        BOOST_CHECK_EQUAL (a.sum().exponent(), -infinity);
+        a += log_float (2.5, math::as_exponent());
+        BOOST_CHECK_EQUAL (a.sum().exponent(), 2.5);
+        a += log_float();
+        BOOST_CHECK_EQUAL (a.sum().exponent(), 2.5);
+        a += log_float (2.5, math::as_exponent());
+        BOOST_CHECK_CLOSE (a.sum().exponent(), 2.5 + std::log (2.), 1e-12);
+    }
+    {
+        accumulator a;
+        a += log_float (1, math::as_exponent());
+        a += log_float (infinity, math::as_exponent());
+        a += log_float (3, math::as_exponent());
+        a += log_float (infinity, math::as_exponent());
+        BOOST_CHECK_EQUAL (a.sum().exponent(), infinity);
+    }
+    {
+        accumulator a;
+        a += log_float (1, math::as_exponent());
+        a += log_float (std::numeric_limits <double>::quiet_NaN(),
+            math::as_exponent());
+        a += log_float (3, math::as_exponent());
+        a += log_float (infinity, math::as_exponent());
+        BOOST_CHECK ((boost::math::isnan) (a.sum().exponent()));
+    }
+}
+
+/**
+Sum many values, in increasing, decreasing, and mixed order, and compare with a
+reference computed in long double.
+*/
+BOOST_AUTO_TEST_CASE (test_log_sum_accumulator_accuracy) {
+    typedef math::log_float <double> log_float;
+    std::vector <double> exponents;
+    for (int i = 0; i != 100000; ++ i)
+        exponents.push_back (-200 + .001 * ((i * 7919) % 100003));
+
+    long double reference_sum = 0;
+    for (double exponent : exponents)
+        reference_sum += std::exp ((long double) (exponent + 200));
+    double reference = double (std::log (reference_sum) - 200);
+
+    math::log_sum_accumulator <double> accumulator;
+    log_float pairwise;
+    for (double exponent : exponents) {
+        accumulator += log_float (exponent, math::as_exponent());
+        pairwise += log_float (exponent, math::as_exponent());
+    }
+    double const epsilon = std::numeric_limits <double>::epsilon();
+    // The compensated sum should be much more accurate than repeated
+    // addition.
+    BOOST_CHECK_SMALL (accumulator.sum().exponent() - reference,
+        20 * epsilon * std::abs (reference));
+    BOOST_CHECK (std::abs (accumulator.sum().exponent() - reference)
+        <= std::abs (pairwise.exponent() - reference));
+
+    // Increasing order: rescales at every step.
+    math::log_sum_accumulator <double> increasing;
+    for (int i = 0; i != 1000; ++ i)
+        increasing += log_float (i * .01, math::as_exponent());
+    long double increasing_reference = 0;
+    for (int i = 0; i != 1000; ++ i)
+        increasing_reference += std::exp ((long double) (i * .01));
+    BOOST_CHECK_CLOSE (increasing.sum().exponent(),
+        double (std::log (increasing_reference)), 1e-12);
+}
+
+BOOST_AUTO_TEST_CASE (test_log_sum_accumulator_merge) {
+    typedef math::log_float <float> log_float;
+    math::log_sum_accumulator <float> all, first, second, empty;
+    for (int i = 0; i != 500; ++ i) {
+        log_float value ((i % 13) * -.5f, math::as_exponent());
+        all += value;
+        if (i < 200)
+            first += value;
+        else
+            second += value;
+    }
+    first += empty;
+    first += second;
+    BOOST_CHECK_CLOSE (first.sum().exponent(), all.sum().exponent(), 1e-4);
+
+    empty += first;
+    BOOST_CHECK_EQUAL (empty.sum().exponent(), first.sum().exponent());
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,278 @@
+/*
+Copyright 2026 Rogier van Dalen.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+/** \file
+Test mapped_alphabet.hpp.
+*/
+
+#define BOOST_TEST_MODULE test_mapped_alphabet
+#include "utility/test/boost_unit_test.hpp"
+
+#include "math/mapped_alphabet.hpp"
+
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <boost/utility/string_ref.hpp>
+
+BOOST_AUTO_TEST_SUITE (test_suite_mapped_alphabet)
+
+struct word;
+struct empty {
+    rime::true_type operator == (empty const &) const { return rime::true_; }
+};
+
+typedef math::alphabet <std::string, word, 0xFFFFFF7F, meta::vector<>, 0x80,
+    math::hashed_symbol_mapping> hashed_alphabet;
+typedef math::alphabet <std::string, word, 0xFFFFFF7F, meta::vector<>, 0x80,
+    math::mapped_symbol_mapping> mapped_alphabet;
+
+/**
+Name of a temporary file that is removed when this goes out of scope.
+*/
+struct temporary_file {
+    std::string name;
+    explicit temporary_file (std::string const & name) : name (name) {}
+    ~temporary_file() { std::remove (name.c_str()); }
+};
+
+std::vector <std::string> make_words (int num) {
+    std::vector <std::string> words;
+    for (int i = 0; i != num; ++ i)
+        words.push_back ("word" + std::to_string ((i * 7919) % 10007));
+    // Symbols can contain any bytes, and be empty.
+    words.push_back (std::string ("a\0b", 3));
+    words.push_back ("");
+    return words;
+}
+
+BOOST_AUTO_TEST_CASE (test_mapped_alphabet) {
+    temporary_file file ("test-mapped_alphabet-1.tmp");
+    std::vector <std::string> words = make_words (5000);
+
+    hashed_alphabet original;
+    for (std::string const & w : words)
+        original.add_symbol (w);
+    math::write_alphabet_file (original, file.name);
+
+    mapped_alphabet mapped (file.name);
+    BOOST_CHECK_EQUAL (mapped.normal_symbol_num(), words.size());
+    for (std::size_t i = 0; i != words.size(); ++ i) {
+        auto dense = mapped.get_dense (words [i]);
+        BOOST_CHECK_EQUAL (dense.id(), original.get_dense (words [i]).id());
+        BOOST_CHECK_EQUAL (mapped.get_symbol <std::string> (dense), words [i]);
+        // The same object is returned every time.
+        BOOST_CHECK (&mapped.get_symbol <std::string> (dense)
+            == &mapped.get_symbol <std::string> (dense));
+        BOOST_CHECK_EQUAL (mapped.add_symbol (words [i]).id(), dense.id());
+    }
+    BOOST_CHECK_THROW (mapped.get_dense ("not a word"),
+        math::symbol_not_found_of <std::string>);
+
+    // Add symbols that are not in the file.
+    auto new_dense = mapped.add_symbol ("not a word");
+    BOOST_CHECK_EQUAL (std::size_t (new_dense.id()), words.size());
+    BOOST_CHECK_EQUAL (mapped.get_dense ("not a word").id(), new_dense.id());
+    BOOST_CHECK_EQUAL (mapped.get_symbol <std::string> (new_dense),
+        "not a word");
+    BOOST_CHECK_EQUAL (mapped.normal_symbol_num(), words.size() + 1);
+
+    // Alphabets with special symbols share the normal symbols.
+    auto mapped2 = math::add_special_symbol <empty> (mapped);
+    BOOST_CHECK_EQUAL (mapped2.get_dense ("not a word").id(), new_dense.id());
+    BOOST_CHECK_EQUAL (mapped2.get_dense (words [7]).id(),
+        original.get_dense (words [7]).id());
+
+    // Another alphabet opened over the same file does not see the new symbol.
+    mapped_alphabet other (file.name);
+    BOOST_CHECK_THROW (other.get_dense ("not a word"), math::symbol_not_found);
+
+    // Write the mapped alphabet, including the new symbol, and read it again.
+    temporary_file file2 ("test-mapped_alphabet-2.tmp");
+    math::write_alphabet_file (mapped, file2.name);
+    mapped_alphabet mapped3 (file2.name);
+    BOOST_CHECK_EQUAL (mapped3.normal_symbol_num(), words.size() + 1);
+    BOOST_CHECK_EQUAL (mapped3.get_dense ("not a word").id(), new_dense.id());
+    BOOST_CHECK_EQUAL (mapped3.get_dense (words [0]).id(), 0);
+}
+
+BOOST_AUTO_TEST_CASE (test_mapped_alphabet_bulk) {
+    temporary_file file ("test-mapped_alphabet-7.tmp");
+    std::vector <std::string> words = make_words (1000);
+    hashed_alphabet original;
+    original.add_symbols (words);
+    math::write_alphabet_file (original, file.name);
+
+    mapped_alphabet mapped (file.name);
+    // Symbols in the file, new symbols, and a repeated new symbol.
+    std::vector <std::string> queries = {words [3], "new1", words [0], "new2",
+        "new1", words.back()};
+    std::vector <mapped_alphabet::dense_symbol_type> dense (queries.size());
+    bool missing [6];
+    BOOST_CHECK_EQUAL (mapped.get_dense (queries, dense.data(), missing), 3u);
+    BOOST_CHECK (!missing [0] && missing [1] && !missing [2] && missing [3]
+        && missing [4] && !missing [5]);
+    BOOST_CHECK_EQUAL (dense [2].id(), 0);
+
+    mapped.add_symbols (queries, dense.data());
+    BOOST_CHECK_EQUAL (mapped.normal_symbol_num(), words.size() + 2);
+    BOOST_CHECK_EQUAL (std::size_t (dense [1].id()), words.size());
+    BOOST_CHECK_EQUAL (std::size_t (dense [3].id()), words.size() + 1);
+    BOOST_CHECK (dense [4] == dense [1]);
+    for (std::size_t i = 0; i != queries.size(); ++ i) {
+        BOOST_CHECK (dense [i] == mapped.get_dense (queries [i]));
+        BOOST_CHECK_EQUAL (mapped.get_symbol <std::string> (dense [i]),
+            queries [i]);
+    }
+
+    BOOST_CHECK_EQUAL (mapped.get_dense (queries, dense.data(), missing), 0u);
+
+    // Keys of other types, for symbols in the file and symbols added later.
+    std::string text = words [5] + " new2";
+    BOOST_CHECK_EQUAL (mapped.get_dense (boost::string_ref (
+        text.data(), words [5].size())).id(), 5);
+    BOOST_CHECK (mapped.get_dense (boost::string_ref (
+        text.data() + words [5].size() + 1, 4)) == dense [3]);
+    BOOST_CHECK (mapped.get_dense ("new1") == dense [1]);
+    BOOST_CHECK_THROW (mapped.get_dense ("new3"),
+        math::symbol_not_found_of <std::string>);
+}
+
+BOOST_AUTO_TEST_CASE (test_mapped_alphabet_empty) {
+    temporary_file file ("test-mapped_alphabet-3.tmp");
+    math::write_alphabet_file (hashed_alphabet(), file.name);
+    mapped_alphabet mapped (file.name);
+    BOOST_CHECK_EQUAL (mapped.normal_symbol_num(), 0u);
+    BOOST_CHECK_THROW (mapped.get_dense ("a"), math::symbol_not_found);
+    BOOST_CHECK_EQUAL (mapped.add_symbol ("a").id(), 0);
+    BOOST_CHECK_EQUAL (mapped.get_symbol <std::string> (
+        mapped.get_dense ("a")), "a");
+}
+
+BOOST_AUTO_TEST_CASE (test_mapped_alphabet_errors) {
+    BOOST_CHECK_THROW (mapped_alphabet ("does-not-exist.tmp"),
+        math::alphabet_file_error);
+
+    {
+        temporary_file file ("test-mapped_alphabet-4.tmp");
+        {
+            std::ofstream output (file.name.c_str());
+            output << "This is not an alphabet file, although it is long.";
+        }
+        BOOST_CHECK_THROW (mapped_alphabet (file.name),
+            math::alphabet_file_error);
+    }
+
+    // Too many symbols for the alphabet type.
+    {
+        temporary_file file ("test-mapped_alphabet-5.tmp");
+        hashed_alphabet original;
+        original.add_symbol ("a");
+        original.add_symbol ("b");
+        original.add_symbol ("c");
+        math::write_alphabet_file (original, file.name);
+
+        typedef math::alphabet <std::string, word, 2, meta::vector<>, 2,
+            math::mapped_symbol_mapping> small_alphabet;
+        BOOST_CHECK_THROW (small_alphabet (file.name),
+            math::alphabet_overflow);
+
+        // A truncated file.
+        std::string contents;
+        {
+            std::ifstream input (file.name.c_str(), std::ios::binary);
+            contents.assign (std::istreambuf_iterator <char> (input),
+                std::istreambuf_iterator <char>());
+        }
+        {
+            std::ofstream output (file.name.c_str(), std::ios::binary);
+            output.write (contents.data(), contents.size() - 1);
+        }
+        BOOST_CHECK_THROW (mapped_alphabet (file.name),
+            math::alphabet_file_error);
+    }
+
+    // A hash table without empty slots.
+    {
+        temporary_file file ("test-mapped_alphabet-8.tmp");
+        hashed_alphabet original;
+        original.add_symbol ("a");
+        original.add_symbol ("b");
+        math::write_alphabet_file (original, file.name);
+
+        std::string contents;
+        {
+            std::ifstream input (file.name.c_str(), std::ios::binary);
+            contents.assign (std::istreambuf_iterator <char> (input),
+                std::istreambuf_iterator <char>());
+        }
+        math::detail::alphabet_file_header header;
+        std::memcpy (&header, contents.data(), sizeof (header));
+        std::size_t slots = sizeof (header)
+            + (header.symbol_num + 1) * sizeof (std::uint64_t);
+        for (std::uint64_t slot = 0; slot != header.slot_num; ++ slot) {
+            math::detail::alphabet_file_slot full = {slot, 0};
+            std::memcpy (&contents [slots + slot * sizeof (full)], &full,
+                sizeof (full));
+        }
+        {
+            std::ofstream output (file.name.c_str(), std::ios::binary);
+            output.write (contents.data(), contents.size());
+        }
+
+        mapped_alphabet mapped (file.name);
+        BOOST_CHECK_THROW (mapped.get_dense ("c"), math::alphabet_file_error);
+    }
+}
+
+/**
+Convert symbols in the file to strings from a number of threads at the same
+time.
+*/
+BOOST_AUTO_TEST_CASE (test_mapped_alphabet_concurrent) {
+    temporary_file file ("test-mapped_alphabet-6.tmp");
+    std::vector <std::string> words = make_words (2000);
+    {
+        hashed_alphabet original;
+        for (std::string const & w : words)
+            original.add_symbol (w);
+        math::write_alphabet_file (original, file.name);
+    }
+    mapped_alphabet mapped (file.name);
+
+    std::vector <std::vector <std::string const *>> addresses (4);
+    std::vector <std::thread> threads;
+    for (std::size_t t = 0; t != addresses.size(); ++ t) {
+        threads.emplace_back ([&, t]() {
+                for (std::string const & w : words)
+                    addresses [t].push_back (&mapped.get_symbol <std::string> (
+                        mapped.get_dense (w)));
+            });
+    }
+    for (std::thread & thread : threads)
+        thread.join();
+    for (std::size_t t = 1; t != addresses.size(); ++ t)
+        BOOST_CHECK (addresses [t] == addresses [0]);
+    for (std::size_t i = 0; i != words.size(); ++ i)
+        BOOST_CHECK_EQUAL (*addresses [0][i], words [i]);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
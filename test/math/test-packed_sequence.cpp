@@ -0,0 +1,170 @@
+/*
+Copyright 2026 Rogier van Dalen.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+
+/** \file
+Test packed_sequence.hpp.
+*/
+
+#define BOOST_TEST_MODULE test_packed_sequence
+#include "utility/test/boost_unit_test.hpp"
+
+#include "math/packed_sequence.hpp"
+
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+BOOST_AUTO_TEST_SUITE (test_suite_packed_sequence)
+
+struct word;
+
+struct epsilon {
+    rime::true_type operator == (epsilon const &) const
+    { return rime::true_; }
+};
+
+typedef math::alphabet <std::string, word> alphabet_type;
+typedef alphabet_type::dense_symbol_type symbol_type;
+
+template <class Direction> void check_packed_sequence (
+    std::vector <symbol_type> const & vocabulary, symbol_type special,
+    math::symbol_packing <int> const & packing)
+{
+    typedef math::sequence <symbol_type, Direction> sequence;
+    typedef math::packed_sequence <symbol_type, Direction> packed_sequence;
+
+    // Empty and annihilator.
+    packed_sequence empty;
+    BOOST_CHECK (empty.empty());
+    BOOST_CHECK (sequence (empty) == sequence());
+    BOOST_CHECK (packed_sequence (sequence(), packing) == empty);
+    packed_sequence annihilator =
+        math::sequence_annihilator <symbol_type, Direction>();
+    BOOST_CHECK (annihilator.is_annihilator());
+    BOOST_CHECK (sequence (annihilator).is_annihilator());
+    BOOST_CHECK (annihilator != empty);
+
+    // A default-constructed packing stores symbols at their full width.
+    math::symbol_packing <int> full_packing;
+    std::vector <symbol_type> close (vocabulary.begin() + 1000,
+        vocabulary.begin() + 1010);
+    packed_sequence full (sequence (close), full_packing);
+    BOOST_CHECK_EQUAL (full.bits_per_symbol(), 32u);
+    BOOST_CHECK (sequence (full) == sequence (close));
+
+    // A packing given at run time.
+    packed_sequence packed_close (sequence (close),
+        math::symbol_packing <int> (close.front().id(), 4));
+    BOOST_CHECK_EQUAL (packed_close.size(), 10u);
+    BOOST_CHECK_EQUAL (packed_close.bits_per_symbol(), 4u);
+    BOOST_CHECK_EQUAL (packed_close.packed_size(), 8u);
+    BOOST_CHECK (sequence (packed_close) == sequence (close));
+    for (std::size_t i = 0; i != close.size(); ++ i)
+        BOOST_CHECK (packed_close [i] == close [i]);
+    BOOST_CHECK (packed_close == full);
+    BOOST_CHECK_THROW (packed_sequence (sequence (close),
+        math::symbol_packing <int> (close.front().id(), 3)),
+        std::out_of_range);
+    BOOST_CHECK_THROW (packed_sequence (sequence (close),
+        math::symbol_packing <int> (close.front().id() + 1, 4)),
+        std::out_of_range);
+
+    // One symbol repeated can take no bits at all.
+    packed_sequence repeated (sequence (
+            std::vector <symbol_type> (100, vocabulary [5])),
+        math::symbol_packing <int> (vocabulary [5].id(), 0));
+    BOOST_CHECK_EQUAL (repeated.bits_per_symbol(), 0u);
+    BOOST_CHECK_EQUAL (repeated.packed_size(), 0u);
+    BOOST_CHECK (repeated [99] == vocabulary [5]);
+
+    // With the packing for the alphabet, words from all over a vocabulary of
+    // 65536 words, and special symbols, take 17 bits.
+    std::vector <symbol_type> spread;
+    for (std::size_t i = 0; i != 1000; ++ i)
+        spread.push_back (vocabulary [(i * 7919) % vocabulary.size()]);
+    spread.push_back (vocabulary.front());
+    spread.push_back (vocabulary.back());
+    spread.push_back (special);
+    packed_sequence packed_spread (sequence (spread), packing);
+    BOOST_CHECK_EQUAL (packed_spread.bits_per_symbol(), 17u);
+    BOOST_CHECK_EQUAL (packed_spread.packed_size(),
+        (17 * spread.size() + 63) / 64 * 8);
+    BOOST_CHECK (sequence (packed_spread) == sequence (spread));
+    BOOST_CHECK (packed_sequence (sequence (close), packing).packing()
+        == packed_spread.packing());
+
+    // common_length gives the length of the result of plus, whether the
+    // sequences are packed the same way or not.
+    std::vector <std::vector <symbol_type>> examples;
+    examples.push_back (std::vector <symbol_type>());
+    examples.push_back (close);
+    examples.push_back (spread);
+    for (std::size_t length = 0; length <= spread.size(); length += 97) {
+        examples.push_back (std::vector <symbol_type> (
+            spread.begin(), spread.begin() + length));
+        examples.push_back (std::vector <symbol_type> (
+            spread.end() - length, spread.end()));
+        std::vector <symbol_type> changed = spread;
+        changed [length % spread.size()] = vocabulary [1];
+        examples.push_back (changed);
+    }
+    for (auto const & symbols1 : examples) {
+        for (auto const & symbols2 : examples) {
+            sequence sequence1 (symbols1);
+            sequence sequence2 (symbols2);
+            std::size_t expected = math::plus (sequence1, sequence2)
+                .storage().size();
+            packed_sequence packed1 (sequence1, packing);
+            packed_sequence packed2 (sequence2, packing);
+            packed_sequence full2 (sequence2, full_packing);
+            BOOST_CHECK_EQUAL (math::common_length (packed1, packed2),
+                expected);
+            BOOST_CHECK_EQUAL (math::common_length (packed1, full2),
+                expected);
+            BOOST_CHECK_EQUAL (packed1 == packed2, sequence1 == sequence2);
+            BOOST_CHECK_EQUAL (packed1 == full2, sequence1 == sequence2);
+        }
+    }
+}
+
+BOOST_AUTO_TEST_CASE (test_packed_sequence) {
+    alphabet_type alphabet;
+    std::vector <symbol_type> vocabulary;
+    for (int i = 0; i != 65536; ++ i)
+        vocabulary.push_back (alphabet.add_symbol ("w" + std::to_string (i)));
+    auto alphabet_with_epsilon =
+        math::add_special_symbol <epsilon> (alphabet);
+    symbol_type special = alphabet_with_epsilon.get_dense (epsilon());
+
+    // Alphabets that share normal symbols give the same packing.
+    math::symbol_packing <int> packing (alphabet);
+    BOOST_CHECK (math::symbol_packing <int> (alphabet_with_epsilon)
+        == packing);
+    BOOST_CHECK_EQUAL (packing.lowest(), -0x80);
+    BOOST_CHECK_EQUAL (packing.bits_per_symbol(), 17u);
+    BOOST_CHECK (packing.contains (special.id()));
+    BOOST_CHECK (packing.contains (vocabulary.back().id()));
+    BOOST_CHECK (packing.contains (0x20000 - 0x81));
+    BOOST_CHECK (!packing.contains (0x20000 - 0x80));
+    BOOST_CHECK (math::symbol_packing <int> (alphabet_type())
+        == math::symbol_packing <int> (-0x80, 7));
+
+    check_packed_sequence <math::left> (vocabulary, special, packing);
+    check_packed_sequence <math::right> (vocabulary, special, packing);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,155 @@
+/*
+Copyright 2026 Rogier van Dalen.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+/** \file
+Test reduce.hpp.
+*/
+
+#define BOOST_TEST_MODULE test_reduce
+#include "utility/test/boost_unit_test.hpp"
+
+#include "math/reduce.hpp"
+
+#include <list>
+#include <string>
+#include <vector>
+
+#include <boost/mpl/assert.hpp>
+
+#include "math/arithmetic_magma.hpp"
+#include "math/sequence.hpp"
+
+BOOST_AUTO_TEST_SUITE (test_suite_reduce)
+
+BOOST_AUTO_TEST_CASE (test_reduce_integer) {
+    BOOST_MPL_ASSERT ((math::is::associative <math::callable::plus, int>));
+
+    std::vector <int> values;
+    int expected = 0;
+    for (int i = 0; i != 100000; ++ i) {
+        values.push_back (i % 101 - 50);
+        expected += values.back();
+    }
+
+    BOOST_CHECK_EQUAL (math::reduce (values, math::plus), expected);
+    BOOST_CHECK_EQUAL (math::reduce (values, math::plus, 1), expected);
+    BOOST_CHECK_EQUAL (math::reduce (values, math::plus, 7), expected);
+    BOOST_CHECK_EQUAL (math::reduce (values, math::plus, 1000000), expected);
+
+    std::vector <int> one (1, 5);
+    BOOST_CHECK_EQUAL (math::reduce (one, math::plus), 5);
+    BOOST_CHECK_EQUAL (math::reduce (one, math::times, 3), 5);
+
+    // Not random-access: sequential.
+    std::list <int> list (values.begin(), values.end());
+    BOOST_CHECK_EQUAL (math::reduce (list, math::plus), expected);
+
+    // Empty ranges have no result.
+    std::vector <int> empty;
+    BOOST_CHECK_THROW (math::reduce (empty, math::plus), std::invalid_argument);
+    BOOST_CHECK_THROW (math::reduce (std::list <int>(), math::plus),
+        std::invalid_argument);
+
+    // A chunk size of 0 is an error.
+    BOOST_CHECK_THROW (math::reduce (values, math::plus, 0),
+        std::invalid_argument);
+}
+
+/**
+For a fixed chunk size, the result is the same every time, even though the
+chunks may be processed by different threads.
+It is equal to combining the chunks by hand.
+*/
+BOOST_AUTO_TEST_CASE (test_reduce_reproducible) {
+    std::vector <double> values;
+    for (int i = 0; i != 100000; ++ i)
+        values.push_back (.1 * ((i * 7919) % 1009) - 50.3);
+
+    std::size_t const chunk_size = 64;
+    double expected = 0;
+    for (std::size_t first = 0; first < values.size(); first += chunk_size) {
+        double chunk = values [first];
+        for (std::size_t i = first + 1;
+                i != std::min (first + chunk_size, values.size()); ++ i)
+            chunk += values [i];
+        if (first == 0)
+            expected = chunk;
+        else
+            expected += chunk;
+    }
+
+    for (int repetition = 0; repetition != 10; ++ repetition)
+        BOOST_CHECK_EQUAL (math::reduce (values, math::plus, chunk_size),
+            expected);
+
+    // The number of threads does not change the result.
+    for (std::size_t thread_num : {1, 2, 3, 8, 100})
+        BOOST_CHECK_EQUAL (
+            math::reduce (values, math::plus, chunk_size, thread_num),
+            expected);
+}
+
+BOOST_AUTO_TEST_CASE (test_reduce_non_associative) {
+    BOOST_MPL_ASSERT_NOT ((
+        math::is::associative <math::callable::minus<>, int>));
+
+    std::vector <int> values;
+    for (int i = 0; i != 10000; ++ i)
+        values.push_back (i % 13);
+    int expected = values.front();
+    for (std::size_t i = 1; i != values.size(); ++ i)
+        expected -= values [i];
+
+    BOOST_CHECK_EQUAL (
+        math::reduce (values, math::callable::minus<>(), 10), expected);
+}
+
+/**
+Concatenation of sequences is associative but not commutative, so the order of
+the chunks must be kept.
+*/
+BOOST_AUTO_TEST_CASE (test_reduce_non_commutative) {
+    typedef math::sequence <char> sequence;
+    BOOST_MPL_ASSERT ((math::is::associative <math::callable::times, sequence>));
+    BOOST_MPL_ASSERT_NOT ((
+        math::is::commutative <math::callable::times, sequence>));
+
+    std::vector <sequence> values;
+    std::string expected;
+    for (int i = 0; i != 5000; ++ i) {
+        std::string symbols (1 + i % 3, char ('a' + i % 26));
+        values.push_back (sequence (symbols));
+        expected += symbols;
+    }
+
+    BOOST_CHECK (math::reduce (values, math::times, 17)
+        == sequence (expected));
+    BOOST_CHECK (math::reduce (values, math::times) == sequence (expected));
+    BOOST_CHECK (math::reduce (values, math::times, 17, 2)
+        == sequence (expected));
+}
+
+/**
+For a fixed number of operands, math::times can be called with all of them.
+By default, they are multiplied from left to right.
+*/
+BOOST_AUTO_TEST_CASE (test_times_many_operands) {
+    BOOST_CHECK_EQUAL (math::times (2, 3, 7), 42);
+    BOOST_CHECK_EQUAL (math::times (2, 3, 7, -1, 5), -210);
+    BOOST_CHECK_EQUAL (math::times (.5, 3., 4.), 6.);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
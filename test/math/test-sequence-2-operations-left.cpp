@@ -33,6 +33,7 @@ BOOST_AUTO_TEST_CASE (test_sequence) {
     test_construction <math::left>();
     test_comparison <math::left> ("ab", "abc");
     test_times <math::left> ();
+    test_times_many <math::left>();
     test_plus <math::left> ("ab", "abc");
     test_pick <math::left>();
     test_choose <math::left> ("ab", "abc");
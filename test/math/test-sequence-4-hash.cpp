@@ -40,6 +40,13 @@ template <class Direction> void check_hash_homogeneous() {
     examples.push_back (sequence (std::string ("a\0")));
     examples.push_back (sequence (std::string ("abcd")));
     examples.push_back (math::sequence_annihilator <char, Direction>());
+    // Long sequences, whose hash value is cached, and a slice of a longer one
+    // that is equal to one of them, whose hash value is not.
+    sequence long_sequence (std::string (60, 'a'));
+    sequence longer_sequence (std::string (61, 'a'));
+    examples.push_back (long_sequence);
+    examples.push_back (longer_sequence);
+    examples.push_back (math::plus (longer_sequence, long_sequence));
 
     math::check_hash (examples);
 }
@@ -0,0 +1,240 @@
+/*
+Copyright 2026 Rogier van Dalen.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+
+/** \file
+Test shared_sequence in sequence.hpp.
+*/
+
+#define BOOST_TEST_MODULE test_sequence_shared
+#include "utility/test/boost_unit_test.hpp"
+
+#include "math/sequence.hpp"
+
+#include <string>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+#include <boost/functional/hash.hpp>
+
+#include "range/std/container.hpp"
+
+BOOST_AUTO_TEST_SUITE (test_suite_sequence_shared)
+
+template <class Direction> void check_shared_sequence() {
+    typedef math::sequence <char, Direction> sequence;
+    typedef math::shared_sequence <char, Direction> shared_sequence;
+    typedef math::single_sequence <char, Direction> single_sequence;
+    typedef math::empty_sequence <char, Direction> empty_sequence;
+    typedef math::sequence_annihilator <char, Direction> annihilator;
+
+    typedef math::sequence_tag <char, Direction> tag;
+
+    static_assert (std::is_same <typename math::operation::unify_type <tag,
+        shared_sequence, single_sequence>::type, shared_sequence>::value, "");
+    static_assert (std::is_same <typename math::operation::unify_type <tag,
+        sequence, shared_sequence>::type, shared_sequence>::value, "");
+
+    shared_sequence empty;
+    BOOST_CHECK (!empty.is_annihilator());
+    BOOST_CHECK (empty.empty());
+    BOOST_CHECK_EQUAL (empty.size(), 0u);
+    BOOST_CHECK (range::empty (empty.symbols()));
+    BOOST_CHECK (empty == empty_sequence());
+
+    // Collect symbols one at a time, as along a path.
+    shared_sequence path;
+    std::string expected;
+    for (int i = 0; i != 1000; ++ i) {
+        char symbol = char ('a' + i % 26);
+        auto product = path * single_sequence (symbol);
+        static_assert (std::is_same <decltype (product), shared_sequence
+            >::value, "times with a shared_sequence returns one.");
+        path = product;
+        expected.push_back (symbol);
+        BOOST_CHECK_EQUAL (path.size(), expected.size());
+    }
+    BOOST_CHECK (path == sequence (expected));
+    BOOST_CHECK_EQUAL (range::size (path.symbols()), 1000u);
+    BOOST_CHECK_EQUAL (range::first (path.symbols()), 'a');
+
+    // Concatenate trees.
+    shared_sequence abc (std::string ("abc"));
+    shared_sequence def = sequence (std::string ("def"));
+    shared_sequence abcdef = abc * def;
+    BOOST_CHECK (abcdef == sequence (std::string ("abcdef")));
+    BOOST_CHECK ((abcdef * abcdef)
+        == sequence (std::string ("abcdefabcdef")));
+    BOOST_CHECK (sequence (std::string ("x")) * abc
+        == sequence (std::string ("xabc")));
+    BOOST_CHECK (abc * empty_sequence() == abc);
+    BOOST_CHECK (empty * abc == abc);
+
+    // Annihilator.
+    shared_sequence zero = annihilator();
+    BOOST_CHECK (zero.is_annihilator());
+    BOOST_CHECK ((zero * abc).is_annihilator());
+    BOOST_CHECK ((abc * zero).is_annihilator());
+    BOOST_CHECK ((abc * annihilator()).is_annihilator());
+    BOOST_CHECK (sequence (zero).is_annihilator());
+    BOOST_CHECK (zero == annihilator());
+
+    // Conversion to sequence.
+    sequence converted = abcdef;
+    BOOST_CHECK (converted == sequence (std::string ("abcdef")));
+
+    // Other operations go through sequence.
+    BOOST_CHECK (math::choose (abc, abcdef) == abc);
+    BOOST_CHECK (math::compare (abc, abcdef) == math::compare (
+        sequence (std::string ("abc")), sequence (std::string ("abcdef"))));
+    BOOST_CHECK (abcdef + abcdef == abcdef);
+    BOOST_CHECK (abcdef + zero == abcdef);
+
+    if (std::is_same <Direction, math::left>::value) {
+        BOOST_CHECK (abcdef + abc == abc);
+        BOOST_CHECK (math::divide <Direction> (abcdef, abc) == def);
+    } else {
+        BOOST_CHECK (abcdef + def == def);
+        BOOST_CHECK (math::divide <Direction> (abcdef, def) == abc);
+    }
+
+    // Hash.
+    boost::hash <shared_sequence> shared_hash;
+    boost::hash <sequence> sequence_hash;
+    BOOST_CHECK_EQUAL (shared_hash (abcdef),
+        sequence_hash (sequence (std::string ("abcdef"))));
+    BOOST_CHECK_EQUAL (shared_hash (zero), sequence_hash (annihilator()));
+
+    // Long sequences, and slices of them.
+    std::string long_symbols (100, 'a');
+    shared_sequence long_sequence (long_symbols);
+    std::size_t long_hash = shared_hash (long_sequence);
+    BOOST_CHECK_EQUAL (shared_hash (long_sequence), long_hash);
+    BOOST_CHECK_EQUAL (sequence_hash (sequence (long_sequence)), long_hash);
+    BOOST_CHECK_EQUAL (sequence_hash (sequence (long_symbols)), long_hash);
+    shared_sequence slice = math::plus (long_sequence,
+        shared_sequence (std::string (90, 'a')));
+    BOOST_CHECK_EQUAL (shared_hash (slice),
+        sequence_hash (sequence (std::string (90, 'a'))));
+}
+
+BOOST_AUTO_TEST_CASE (test_shared_sequence) {
+    check_shared_sequence <math::left>();
+    check_shared_sequence <math::right>();
+}
+
+std::string to_string (math::shared_sequence <char> const & s) {
+    return std::string (s.storage().begin(), s.storage().end());
+}
+
+/**
+Flatten nodes in different orders, so that flattening a node finds some of its
+descendants flattened already.
+*/
+BOOST_AUTO_TEST_CASE (test_shared_sequence_flatten_order) {
+    typedef math::shared_sequence <char> shared_sequence;
+    typedef math::single_sequence <char> single_sequence;
+
+    // Flatten every prefix of a path while it is built.
+    shared_sequence path;
+    std::vector <shared_sequence> prefixes;
+    std::string expected;
+    for (int i = 0; i != 500; ++ i) {
+        char symbol = char ('a' + i % 26);
+        path = path * single_sequence (symbol);
+        expected.push_back (symbol);
+        if (i % 3 == 0)
+            BOOST_CHECK_EQUAL (to_string (path), expected);
+        prefixes.push_back (path);
+    }
+    BOOST_CHECK_EQUAL (to_string (path), expected);
+    for (std::size_t i = 0; i != prefixes.size(); ++ i)
+        BOOST_CHECK_EQUAL (to_string (prefixes [i]), expected.substr (0, i + 1));
+
+    // A tree whose subtrees are flattened after the root.
+    shared_sequence ab = shared_sequence (std::string ("a"))
+        * shared_sequence (std::string ("b"));
+    shared_sequence cd = shared_sequence (std::string ("c"))
+        * shared_sequence (std::string ("d"));
+    shared_sequence abcd = ab * cd;
+    shared_sequence abcdab = abcd * ab;
+    BOOST_CHECK_EQUAL (to_string (abcd), "abcd");
+    BOOST_CHECK_EQUAL (to_string (ab), "ab");
+    BOOST_CHECK_EQUAL (to_string (abcdab), "abcdab");
+    BOOST_CHECK_EQUAL (to_string (cd), "cd");
+    BOOST_CHECK_EQUAL (to_string (abcdab * cd), "abcdabcd");
+}
+
+/**
+A shared_sequence that is built outside an arena_scope, but flattened inside
+one, does not use the arena.
+*/
+BOOST_AUTO_TEST_CASE (test_shared_sequence_flatten_in_arena) {
+    typedef math::shared_sequence <char> shared_sequence;
+    std::string left (100, 'a');
+    std::string right (100, 'b');
+    shared_sequence s = shared_sequence (left) * shared_sequence (right);
+
+    math::arena a;
+    {
+        math::arena_scope scope (a);
+        BOOST_CHECK_EQUAL (to_string (s), left + right);
+    }
+    BOOST_CHECK_EQUAL (a.allocated(), 0u);
+    a.release();
+    BOOST_CHECK_EQUAL (to_string (s), left + right);
+}
+
+/**
+Flatten nodes that share descendants from a number of threads at once.
+*/
+BOOST_AUTO_TEST_CASE (test_shared_sequence_flatten_concurrent) {
+    typedef math::shared_sequence <char> shared_sequence;
+    typedef math::single_sequence <char> single_sequence;
+
+    for (int repetition = 0; repetition != 20; ++ repetition) {
+        std::vector <shared_sequence> prefixes;
+        std::string expected;
+        shared_sequence path;
+        for (int i = 0; i != 200; ++ i) {
+            char symbol = char ('a' + i % 26);
+            path = path * single_sequence (symbol);
+            expected.push_back (symbol);
+            prefixes.push_back (path);
+        }
+
+        std::vector <std::string> results (4);
+        std::vector <std::thread> threads;
+        for (std::size_t t = 0; t != results.size(); ++ t) {
+            threads.emplace_back ([&, t]() {
+                    // Each thread flattens the prefixes in a different order.
+                    for (std::size_t i = 0; i != prefixes.size(); ++ i) {
+                        std::size_t index = (i * (2 * t + 1) + 37 * t)
+                            % prefixes.size();
+                        to_string (prefixes [index]);
+                    }
+                    results [t] = to_string (path);
+                });
+        }
+        for (std::thread & thread : threads)
+            thread.join();
+        for (std::string const & result : results)
+            BOOST_CHECK_EQUAL (result, expected);
+    }
+}
+
+BOOST_AUTO_TEST_SUITE_END()
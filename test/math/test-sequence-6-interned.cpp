@@ -0,0 +1,206 @@
+/*
+Copyright 2026 Rogier van Dalen.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+
+/** \file
+Test interned_sequence in sequence.hpp.
+*/
+
+#define BOOST_TEST_MODULE test_sequence_interned
+#include "utility/test/boost_unit_test.hpp"
+
+#include "math/sequence.hpp"
+
+#include <string>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+#include <boost/functional/hash.hpp>
+
+#include "range/std/container.hpp"
+
+BOOST_AUTO_TEST_SUITE (test_suite_sequence_interned)
+
+template <class Direction> void check_interned_sequence() {
+    typedef math::sequence <char, Direction> sequence;
+    typedef math::interned_sequence <char, Direction> interned_sequence;
+    typedef math::shared_sequence <char, Direction> shared_sequence;
+    typedef math::single_sequence <char, Direction> single_sequence;
+    typedef math::empty_sequence <char, Direction> empty_sequence;
+    typedef math::sequence_annihilator <char, Direction> annihilator;
+
+    typedef math::sequence_tag <char, Direction> tag;
+
+    static_assert (std::is_same <typename math::operation::unify_type <tag,
+        interned_sequence, interned_sequence>::type, interned_sequence
+        >::value, "");
+    static_assert (std::is_same <typename math::operation::unify_type <tag,
+        interned_sequence, single_sequence>::type, sequence>::value, "");
+    static_assert (std::is_same <typename math::operation::unify_type <tag,
+        interned_sequence, shared_sequence>::type, shared_sequence>::value,
+        "");
+    // Interning is explicit.
+    static_assert (!std::is_convertible <sequence, interned_sequence>::value,
+        "");
+    static_assert (std::is_convertible <interned_sequence, sequence>::value,
+        "");
+
+    interned_sequence empty;
+    BOOST_CHECK (!empty.is_annihilator());
+    BOOST_CHECK (empty.empty());
+    BOOST_CHECK_EQUAL (empty.size(), 0u);
+    BOOST_CHECK (range::empty (empty.symbols()));
+    BOOST_CHECK (empty == empty_sequence());
+    BOOST_CHECK (empty == interned_sequence (empty_sequence()));
+
+    std::string long_symbols (100, 'x');
+    interned_sequence abc (std::string ("abc"));
+    interned_sequence abc2 (sequence (std::string ("abc")));
+    interned_sequence long1 (long_symbols);
+    interned_sequence long2 = interned_sequence (sequence (long_symbols));
+
+    // Equal symbols share the same storage.
+    BOOST_CHECK (abc == abc2);
+    BOOST_CHECK (abc.symbols().begin() == abc2.symbols().begin());
+    BOOST_CHECK (long1 == long2);
+    BOOST_CHECK (long1.symbols().begin() == long2.symbols().begin());
+    BOOST_CHECK (!(abc == long1));
+    BOOST_CHECK (abc != long1);
+    BOOST_CHECK (abc != empty);
+    BOOST_CHECK_EQUAL (long1.size(), 100u);
+
+    // Comparison with other types.
+    BOOST_CHECK (abc == sequence (std::string ("abc")));
+    BOOST_CHECK (sequence (std::string ("abc")) == abc);
+    BOOST_CHECK (interned_sequence (single_sequence ('a'))
+        == single_sequence ('a'));
+    BOOST_CHECK (abc != single_sequence ('a'));
+
+    // Copies.
+    interned_sequence copy = abc;
+    BOOST_CHECK (copy == abc);
+    copy = long1;
+    BOOST_CHECK (copy == long1);
+    interned_sequence moved = std::move (copy);
+    BOOST_CHECK (moved == long1);
+    copy = std::move (moved);
+    BOOST_CHECK (copy == long1);
+
+    // Annihilator.
+    interned_sequence zero = annihilator();
+    BOOST_CHECK (zero.is_annihilator());
+    BOOST_CHECK (zero == annihilator());
+    BOOST_CHECK (zero == interned_sequence (sequence (annihilator())));
+    BOOST_CHECK (zero != empty);
+    BOOST_CHECK (sequence (zero).is_annihilator());
+    BOOST_CHECK ((zero * abc).is_annihilator());
+
+    // Conversion to sequence shares the symbols.
+    sequence converted = long1;
+    BOOST_CHECK (converted == sequence (long_symbols));
+    BOOST_CHECK (converted.symbols().begin() == long1.symbols().begin());
+
+    // Operations return the types that sequence would.
+    auto product = abc * abc;
+    static_assert (std::is_same <decltype (product), sequence>::value, "");
+    BOOST_CHECK (product == sequence (std::string ("abcabc")));
+    BOOST_CHECK (interned_sequence (product)
+        == interned_sequence (std::string ("abcabc")));
+    auto shared_product = shared_sequence (abc) * abc;
+    static_assert (std::is_same <decltype (shared_product), shared_sequence
+        >::value, "");
+    BOOST_CHECK (shared_product == product);
+
+    BOOST_CHECK (math::choose (abc, long1) == abc);
+    BOOST_CHECK (abc + abc == abc);
+    BOOST_CHECK (abc + zero == abc);
+    BOOST_CHECK (abc + single_sequence ('q') == empty_sequence());
+    BOOST_CHECK (math::compare (abc, long1) == math::compare (
+        sequence (std::string ("abc")), sequence (long_symbols)));
+    BOOST_CHECK (math::reverse <math::callable::times> (abc)
+        == (math::sequence <char,
+            typename math::opposite_direction <Direction>::type> (
+                std::string ("cba"))));
+
+    interned_sequence ab (std::string ("ab"));
+    interned_sequence bc (std::string ("bc"));
+    if (std::is_same <Direction, math::left>::value) {
+        BOOST_CHECK (abc + ab == ab);
+        BOOST_CHECK (math::divide <Direction> (abc, ab)
+            == single_sequence ('c'));
+    } else {
+        BOOST_CHECK (abc + bc == bc);
+        BOOST_CHECK (math::divide <Direction> (abc, bc)
+            == single_sequence ('a'));
+    }
+
+    // Hash.
+    boost::hash <interned_sequence> interned_hash;
+    boost::hash <sequence> sequence_hash;
+    BOOST_CHECK_EQUAL (interned_hash (abc),
+        sequence_hash (sequence (std::string ("abc"))));
+    BOOST_CHECK_EQUAL (interned_hash (long1),
+        sequence_hash (sequence (long_symbols)));
+    BOOST_CHECK_EQUAL (interned_hash (empty), sequence_hash (sequence()));
+    BOOST_CHECK_EQUAL (interned_hash (zero), sequence_hash (annihilator()));
+
+    // Moves do not throw, so that std::vector moves elements when it grows.
+    static_assert (
+        std::is_nothrow_move_constructible <interned_sequence>::value, "");
+    static_assert (
+        std::is_nothrow_move_assignable <interned_sequence>::value, "");
+    interned_sequence target (std::string ("target"));
+    interned_sequence source (long_symbols);
+    target = std::move (target);
+    BOOST_CHECK (target == interned_sequence (std::string ("target")));
+    target = std::move (source);
+    BOOST_CHECK (target == long1);
+    target = std::move (zero);
+    BOOST_CHECK (target.is_annihilator());
+}
+
+BOOST_AUTO_TEST_CASE (test_interned_sequence) {
+    check_interned_sequence <math::left>();
+    check_interned_sequence <math::right>();
+}
+
+// Sequences interned on different threads are the same.
+BOOST_AUTO_TEST_CASE (test_interned_sequence_threads) {
+    typedef math::interned_sequence <int> interned_sequence;
+    std::vector <std::vector <interned_sequence>> results (4);
+    std::vector <std::thread> threads;
+    for (std::size_t t = 0; t != results.size(); ++ t) {
+        threads.emplace_back ([&results, t]() {
+            for (int i = 0; i != 1000; ++ i) {
+                std::vector <int> symbols (i % 37, i % 5);
+                results [t].push_back (interned_sequence (symbols));
+            }
+        });
+    }
+    for (std::thread & thread : threads)
+        thread.join();
+
+    for (std::size_t t = 1; t != results.size(); ++ t) {
+        for (std::size_t i = 0; i != results [t].size(); ++ i) {
+            BOOST_CHECK (results [t][i] == results [0][i]);
+            BOOST_CHECK (results [t][i].symbols().begin()
+                == results [0][i].symbols().begin());
+        }
+    }
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,145 @@
+/*
+Copyright 2026 Rogier van Dalen.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+
+/** \file
+Test sequences with direction "either", which can be divided from both sides.
+*/
+
+#define BOOST_TEST_MODULE test_sequence_either
+#include "utility/test/boost_unit_test.hpp"
+
+#include "math/sequence.hpp"
+
+#include <string>
+#include <type_traits>
+
+#include <boost/mpl/assert.hpp>
+
+#include "range/std/container.hpp"
+
+BOOST_AUTO_TEST_SUITE (test_suite_sequence_either)
+
+typedef math::sequence <char, math::either> sequence;
+typedef math::empty_sequence <char, math::either> empty_sequence;
+typedef math::single_sequence <char, math::either> single_sequence;
+typedef math::optional_sequence <char, math::either> optional_sequence;
+typedef math::sequence_annihilator <char, math::either> annihilator;
+typedef math::shared_sequence <char, math::either> shared_sequence;
+
+typedef math::sequence_tag <char, math::either> tag;
+
+BOOST_AUTO_TEST_CASE (test_sequence_either_properties) {
+    BOOST_MPL_ASSERT ((math::has <math::callable::times (sequence, sequence)>));
+    BOOST_MPL_ASSERT ((
+        math::has <math::callable::choose (sequence, sequence)>));
+    BOOST_MPL_ASSERT ((math::has <
+        math::callable::divide <math::left> (sequence, sequence)>));
+    BOOST_MPL_ASSERT ((math::has <
+        math::callable::divide <math::right> (sequence, sequence)>));
+
+    // Left and right division are different, and there is no plus.
+    BOOST_MPL_ASSERT_NOT ((math::has <
+        math::callable::divide <math::either> (sequence, sequence)>));
+    BOOST_MPL_ASSERT_NOT ((
+        math::has <math::callable::plus (sequence, sequence)>));
+
+    BOOST_MPL_ASSERT ((math::is::semiring <math::either,
+        math::callable::times, math::callable::choose, sequence>));
+    BOOST_MPL_ASSERT_NOT ((math::is::semiring <math::left,
+        math::callable::times, math::callable::plus, sequence>));
+    BOOST_MPL_ASSERT_NOT ((math::is::semiring <math::right,
+        math::callable::times, math::callable::plus, sequence>));
+
+    static_assert (std::is_same <math::operation::unify_type <tag,
+        single_sequence, empty_sequence>::type, optional_sequence>::value,
+        "");
+    static_assert (std::is_same <math::operation::unify_type <tag,
+        shared_sequence, single_sequence>::type, shared_sequence>::value, "");
+}
+
+BOOST_AUTO_TEST_CASE (test_sequence_either_divide) {
+    sequence abcd (std::string ("abcd"));
+    sequence ab (std::string ("ab"));
+    sequence cd (std::string ("cd"));
+
+    BOOST_CHECK (math::times (ab, cd) == abcd);
+
+    BOOST_CHECK (math::divide <math::left> (abcd, ab) == cd);
+    BOOST_CHECK (math::divide <math::right> (abcd, cd) == ab);
+    BOOST_CHECK_THROW (math::divide <math::left> (abcd, cd),
+        math::operation_undefined);
+    BOOST_CHECK_THROW (math::divide <math::right> (abcd, ab),
+        math::operation_undefined);
+
+    BOOST_CHECK (math::divide <math::left> (abcd, single_sequence ('a'))
+        == sequence (std::string ("bcd")));
+    BOOST_CHECK (math::divide <math::right> (abcd, single_sequence ('d'))
+        == sequence (std::string ("abc")));
+    BOOST_CHECK (math::divide <math::right> (abcd, optional_sequence())
+        == abcd);
+    BOOST_CHECK (math::divide <math::left> (
+        single_sequence ('a'), single_sequence ('a')) == empty_sequence());
+
+    BOOST_CHECK_THROW (math::divide <math::left> (abcd, annihilator()),
+        math::divide_by_zero);
+    BOOST_CHECK (math::divide <math::right> (annihilator(), ab)
+        .is_annihilator());
+
+    // Remove symbols from both ends of a long sequence.
+    // The results share the memory of the original.
+    std::string symbols;
+    for (int i = 0; i != 1000; ++ i)
+        symbols.push_back (char ('a' + i % 26));
+    sequence current (symbols);
+    char const * first = current.storage().begin();
+    std::size_t begin = 0;
+    std::size_t end = symbols.size();
+    while (end - begin >= 2) {
+        current = math::divide <math::left> (current,
+            single_sequence (symbols [begin]));
+        current = math::divide <math::right> (current,
+            single_sequence (symbols [end - 1]));
+        ++ begin;
+        -- end;
+        if (end - begin > 100)
+            BOOST_CHECK (current.storage().begin() == first + begin);
+        BOOST_CHECK (current == sequence (
+            symbols.substr (begin, end - begin)));
+    }
+    BOOST_CHECK (current.empty());
+}
+
+BOOST_AUTO_TEST_CASE (test_sequence_either_order) {
+    sequence ab (std::string ("ab"));
+    sequence ba (std::string ("ba"));
+    sequence abc (std::string ("abc"));
+
+    // Lexicographical order from the front.
+    BOOST_CHECK (math::compare (ab, ba));
+    BOOST_CHECK (!math::compare (ba, ab));
+    BOOST_CHECK (math::compare (ab, abc));
+
+    // Choose prefers shorter sequences.
+    BOOST_CHECK (math::choose (abc, ba) == ba);
+    BOOST_CHECK (math::choose (ba, ab) == ab);
+
+    // Reversing keeps the direction.
+    sequence reversed = math::reverse <math::callable::times> (abc);
+    BOOST_CHECK (reversed == sequence (std::string ("cba")));
+}
+
+BOOST_AUTO_TEST_SUITE_END()
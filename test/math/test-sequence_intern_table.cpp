@@ -0,0 +1,120 @@
+/*
+Copyright 2026 Rogier van Dalen.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+
+/** \file
+Test detail/sequence_intern_table.hpp.
+*/
+
+#define BOOST_TEST_MODULE test_sequence_intern_table
+#include "utility/test/boost_unit_test.hpp"
+
+#include "math/detail/sequence_intern_table.hpp"
+
+#include <functional>
+#include <string>
+#include <thread>
+#include <vector>
+
+BOOST_AUTO_TEST_SUITE (test_suite_sequence_intern_table)
+
+typedef math::detail::sequence_intern_table <char> table_type;
+typedef table_type::entry entry;
+
+entry * acquire (std::string const & symbols) {
+    return table_type::instance().acquire (symbols.data(),
+        symbols.data() + symbols.size(), std::hash <std::string>() (symbols));
+}
+
+BOOST_AUTO_TEST_CASE (test_sequence_intern_table) {
+    table_type & table = table_type::instance();
+    BOOST_CHECK_EQUAL (table.size(), 0u);
+
+    entry * abc = acquire ("abc");
+    BOOST_CHECK_EQUAL (table.size(), 1u);
+    BOOST_CHECK_EQUAL (std::string (abc->symbols().begin(),
+        abc->symbols().end()), "abc");
+    BOOST_CHECK_EQUAL (abc->hash(), std::hash <std::string>() ("abc"));
+
+    // Equal symbols give the same entry.
+    entry * abc2 = acquire ("abc");
+    BOOST_CHECK_EQUAL (abc, abc2);
+    BOOST_CHECK_EQUAL (table.size(), 1u);
+
+    std::string long_symbols (100, 'x');
+    entry * long_entry = acquire (long_symbols);
+    BOOST_CHECK (long_entry != abc);
+    BOOST_CHECK_EQUAL (table.size(), 2u);
+
+    table_type::add_reference (long_entry);
+    table.release (long_entry);
+    BOOST_CHECK_EQUAL (table.size(), 2u);
+    table.release (long_entry);
+    BOOST_CHECK_EQUAL (table.size(), 1u);
+
+    table.release (abc);
+    BOOST_CHECK_EQUAL (table.size(), 1u);
+    table.release (abc2);
+    BOOST_CHECK_EQUAL (table.size(), 0u);
+}
+
+// Entries with the same hash value but different symbols are kept apart.
+BOOST_AUTO_TEST_CASE (test_sequence_intern_table_collision) {
+    table_type & table = table_type::instance();
+    std::string a = "a";
+    std::string b = "b";
+    entry * entry_a = table.acquire (a.data(), a.data() + 1, 5);
+    entry * entry_b = table.acquire (b.data(), b.data() + 1, 5);
+    BOOST_CHECK (entry_a != entry_b);
+    BOOST_CHECK_EQUAL (table.acquire (b.data(), b.data() + 1, 5), entry_b);
+    BOOST_CHECK_EQUAL (table.size(), 2u);
+    table.release (entry_b);
+    table.release (entry_a);
+    table.release (entry_b);
+    BOOST_CHECK_EQUAL (table.size(), 0u);
+}
+
+BOOST_AUTO_TEST_CASE (test_sequence_intern_table_threads) {
+    table_type & table = table_type::instance();
+    std::vector <std::string> words;
+    for (int i = 0; i != 50; ++ i)
+        words.push_back (std::string (1 + i % 7, char ('a' + i % 26)));
+
+    std::vector <std::vector <entry *>> results (4);
+    std::vector <std::thread> threads;
+    for (std::size_t t = 0; t != results.size(); ++ t) {
+        threads.emplace_back ([&words, &results, &table, t]() {
+            for (int repetition = 0; repetition != 200; ++ repetition) {
+                for (std::string const & word : words)
+                    table.release (acquire (word));
+            }
+            for (std::string const & word : words)
+                results [t].push_back (acquire (word));
+        });
+    }
+    for (std::thread & thread : threads)
+        thread.join();
+
+    for (std::size_t t = 1; t != results.size(); ++ t)
+        BOOST_CHECK (results [t] == results [0]);
+    for (std::vector <entry *> const & entries : results) {
+        for (entry * e : entries)
+            table.release (e);
+    }
+    BOOST_CHECK_EQUAL (table.size(), 0u);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,247 @@
+/*
+Copyright 2026 Rogier van Dalen.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+
+/** \file
+Test detail/sequence_storage.hpp.
+*/
+
+#define BOOST_TEST_MODULE test_sequence_storage
+#include "utility/test/boost_unit_test.hpp"
+
+#include "math/detail/sequence_storage.hpp"
+
+#include <memory>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+BOOST_AUTO_TEST_SUITE (test_suite_sequence_storage)
+
+template <class Symbol> std::vector <Symbol> contents (
+    math::detail::sequence_storage <Symbol> const & storage)
+{ return std::vector <Symbol> (storage.begin(), storage.end()); }
+
+BOOST_AUTO_TEST_CASE (test_inline) {
+    typedef math::detail::sequence_storage <int> storage;
+    static_assert (storage::inline_capacity == 8, "");
+    // So that std::vector moves rather than copies when it grows.
+    static_assert (std::is_nothrow_move_constructible <storage>::value, "");
+    static_assert (std::is_nothrow_move_assignable <storage>::value, "");
+    static_assert (std::is_nothrow_move_constructible <
+        math::detail::sequence_storage <std::string>>::value, "");
+
+    storage empty;
+    BOOST_CHECK (empty.empty());
+    BOOST_CHECK (empty.is_inline());
+    BOOST_CHECK (empty.begin() == empty.end());
+
+    std::vector <int> expected;
+    storage s;
+    for (int i = 0; i != 8; ++ i) {
+        s.push_back (i * 3);
+        expected.push_back (i * 3);
+        BOOST_CHECK (s.is_inline());
+        BOOST_CHECK (contents (s) == expected);
+    }
+
+    storage copy (s);
+    BOOST_CHECK (copy.is_inline());
+    BOOST_CHECK (copy.begin() != s.begin());
+    BOOST_CHECK (contents (copy) == expected);
+
+    storage moved (std::move (copy));
+    BOOST_CHECK (contents (moved) == expected);
+
+    // Spill to the heap.
+    s.push_back (24);
+    expected.push_back (24);
+    BOOST_CHECK (!s.is_inline());
+    BOOST_CHECK (contents (s) == expected);
+
+    storage reserved (8);
+    BOOST_CHECK (reserved.is_inline());
+    storage reserved_heap (9);
+    BOOST_CHECK (!reserved_heap.is_inline());
+    BOOST_CHECK (reserved_heap.empty());
+}
+
+BOOST_AUTO_TEST_CASE (test_heap_sharing) {
+    typedef math::detail::sequence_storage <int> storage;
+    std::vector <int> expected;
+    for (int i = 0; i != 100; ++ i)
+        expected.push_back (i);
+
+    storage s (expected.begin(), expected.end());
+    BOOST_CHECK_EQUAL (s.size(), 100u);
+    BOOST_CHECK_EQUAL (s.capacity(), 100u);
+    BOOST_CHECK (contents (s) == expected);
+
+    // Copies share the memory.
+    storage copy (s);
+    BOOST_CHECK (copy.begin() == s.begin());
+    storage assigned;
+    assigned = copy;
+    BOOST_CHECK (assigned.begin() == s.begin());
+
+    // Moving steals the memory.
+    storage moved (std::move (copy));
+    BOOST_CHECK (moved.begin() == s.begin());
+    BOOST_CHECK (copy.empty());
+
+    s = storage();
+    BOOST_CHECK (s.empty());
+    BOOST_CHECK (contents (moved) == expected);
+    BOOST_CHECK (contents (assigned) == expected);
+}
+
+BOOST_AUTO_TEST_CASE (test_slice) {
+    typedef math::detail::sequence_storage <int> storage;
+    std::vector <int> symbols;
+    for (int i = 0; i != 100; ++ i)
+        symbols.push_back (i);
+    storage s (symbols.begin(), symbols.end());
+
+    // Long slices share the heap block.
+    storage tail = s.slice (1, 99);
+    BOOST_CHECK (tail.begin() == s.begin() + 1);
+    BOOST_CHECK (contents (tail)
+        == std::vector <int> (symbols.begin() + 1, symbols.end()));
+    storage middle = tail.slice (10, 50);
+    BOOST_CHECK (middle.begin() == s.begin() + 11);
+    BOOST_CHECK (contents (middle)
+        == std::vector <int> (symbols.begin() + 11, symbols.begin() + 61));
+
+    // Short slices are stored inline.
+    storage short_slice = s.slice (95, 3);
+    BOOST_CHECK (short_slice.is_inline());
+    BOOST_CHECK (contents (short_slice)
+        == std::vector <int> (symbols.begin() + 95, symbols.begin() + 98));
+    storage empty_slice = s.slice (100, 0);
+    BOOST_CHECK (empty_slice.empty());
+
+    // The slice survives the original.
+    s = storage();
+    BOOST_CHECK_EQUAL (middle.begin() [0], 11);
+
+    // Adding to a shared slice copies it first.
+    storage extended = middle;
+    extended.push_back (-1);
+    BOOST_CHECK_EQUAL (extended.size(), 51u);
+    BOOST_CHECK (extended.begin() != middle.begin());
+    BOOST_CHECK_EQUAL (middle.size(), 50u);
+    BOOST_CHECK_EQUAL (extended.begin() [50], -1);
+    BOOST_CHECK_EQUAL (extended.begin() [49], 60);
+
+    // Slices of inline storage.
+    storage small (symbols.begin(), symbols.begin() + 5);
+    BOOST_CHECK (contents (small.slice (1, 3))
+        == std::vector <int> (symbols.begin() + 1, symbols.begin() + 4));
+}
+
+BOOST_AUTO_TEST_CASE (test_non_trivial) {
+    typedef math::detail::sequence_storage <std::shared_ptr <int>> storage;
+    auto value = std::make_shared <int> (5);
+    {
+        storage s;
+        for (int i = 0; i != 20; ++ i)
+            s.push_back (value);
+        BOOST_CHECK_EQUAL (value.use_count(), 21);
+        storage copy (s);
+        BOOST_CHECK_EQUAL (value.use_count(), 21);
+
+        storage inline_storage;
+        inline_storage.push_back (value);
+        storage inline_copy (inline_storage);
+        BOOST_CHECK_EQUAL (value.use_count(), 23);
+        inline_copy = storage (s);
+        BOOST_CHECK_EQUAL (value.use_count(), 22);
+    }
+    BOOST_CHECK_EQUAL (value.use_count(), 1);
+
+    typedef math::detail::sequence_storage <std::string> string_storage;
+    string_storage strings;
+    strings.push_back ("a long string that does not fit in the small buffer");
+    strings.push_back ("b");
+    strings.push_back ("c");
+    BOOST_CHECK_EQUAL (strings.size(), 3u);
+    BOOST_CHECK_EQUAL (strings.begin() [0],
+        "a long string that does not fit in the small buffer");
+    BOOST_CHECK_EQUAL (strings.begin() [2], "c");
+}
+
+struct counting_hash {
+    int * count;
+
+    explicit counting_hash (int & count) : count (&count) {}
+
+    std::size_t operator() (int const * first, int const * last) const {
+        ++ *count;
+        std::size_t result = 0;
+        for (; first != last; ++ first)
+            result = result * 31 + std::size_t (*first);
+        return result;
+    }
+};
+
+BOOST_AUTO_TEST_CASE (test_hash) {
+    typedef math::detail::sequence_storage <int> storage;
+    std::vector <int> symbols;
+    for (int i = 0; i != 100; ++ i)
+        symbols.push_back (i);
+    int count = 0;
+    counting_hash hash (count);
+
+    // Inline storage: computed every time.
+    storage small (symbols.begin(), symbols.begin() + 3);
+    std::size_t small_hash = small.hash (hash);
+    BOOST_CHECK_EQUAL (small.hash (hash), small_hash);
+    BOOST_CHECK_EQUAL (count, 2);
+
+    // A heap block: computed once for all copies.
+    count = 0;
+    storage s (symbols.begin(), symbols.end());
+    std::size_t full_hash = s.hash (hash);
+    storage copy (s);
+    BOOST_CHECK_EQUAL (copy.hash (hash), full_hash);
+    BOOST_CHECK_EQUAL (s.hash (hash), full_hash);
+    BOOST_CHECK_EQUAL (count, 1);
+
+    // Slices do not cover the block, so their hash is computed.
+    storage tail = s.slice (1, 99);
+    BOOST_CHECK_EQUAL (tail.hash (hash),
+        hash (symbols.data() + 1, symbols.data() + 100));
+    storage head = s.slice (0, 99);
+    BOOST_CHECK_EQUAL (head.hash (hash),
+        hash (symbols.data(), symbols.data() + 99));
+
+    // Appending to the block invalidates the value.
+    s = storage();
+    copy = storage();
+    tail = storage();
+    head = storage();
+    count = 0;
+    storage extended (symbols.begin(), symbols.end());
+    extended.reserve (200);
+    BOOST_CHECK_EQUAL (extended.hash (hash), full_hash);
+    extended.push_back (100);
+    symbols.push_back (100);
+    BOOST_CHECK_EQUAL (extended.hash (hash),
+        hash (symbols.data(), symbols.data() + symbols.size()));
+    BOOST_CHECK_EQUAL (count, 3);
+}
+
+BOOST_AUTO_TEST_SUITE_END()